@@ -0,0 +1,19 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// wall clock seconds spent in f.
+template<typename F>
+double Seconds(F&& f)
+{
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// argv[idx] as a count, or fallback.
+inline size_t Arg(int argc, char** argv, int idx, size_t fallback)
+{
+	return argc > idx ? std::strtoull(argv[idx], nullptr, 10) : fallback;
+}
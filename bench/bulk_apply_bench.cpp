@@ -0,0 +1,52 @@
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// One reflected method over N objects: the boxed Member::call loop against
+// BulkApply with a pre-bound invoker, on 1 thread up to the core count.
+
+struct Body
+{
+	float mass;
+	double speed;
+
+	void Scale(float k) { speed *= k; }
+};
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 10000000);
+
+	Registrar<Body>().Regist("Body")
+		.AddVariable(&Body::mass, "mass")
+		.AddFunction(&Body::Scale, "Scale");
+
+	epoch::Guard guard;
+	auto& scale = GetType<Body>()->AsClass()->GetFunctions()[0];
+
+	std::vector<Body> bodies(count, Body{ 1.0f, 1.0 });
+	std::vector<float> factors(count, 1.0000001f);
+	const void* columns[] = { factors.data() };
+
+	double boxed = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			scale.call({ make_ref(bodies[i]), make_copy(factors[i]) });
+		}
+	});
+
+	std::printf("%zu objects, %u hardware threads\n", count, std::thread::hardware_concurrency());
+	std::printf("  Member::call loop    : %8.2f ns per object\n", boxed * 1e9 / count);
+
+	size_t cores = std::max(1u, std::thread::hardware_concurrency());
+	for (size_t threads = 1; threads <= std::max<size_t>(cores, 4); threads *= 2)
+	{
+		ThreadPool pool(threads);
+		double bulk = Seconds([&] { BulkApply(bodies.data(), count, scale, columns, 4096, pool); });
+		std::printf("  BulkApply %2zu threads : %8.2f ns per object, %5.1fx the loop\n", threads, bulk * 1e9 / count, boxed / bulk);
+	}
+	std::printf("  (%.9f)\n", bodies[count / 2].speed);
+	return 0;
+}
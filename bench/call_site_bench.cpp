@@ -0,0 +1,108 @@
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Repeated calls by name from one call site: a full lookup through
+// GetFunctions() and the parameter types every time, against the cache.
+// Run once with only the Move overloads and a few others registered, and
+// once with 32 more methods registered ahead of them.
+
+struct Actor
+{
+	float x = 0;
+
+	void Move(float dx) { x += dx; }
+	void Move(float dx, float scale) { x += dx * scale; }
+	void Reset() { x = 0; }
+	float Get() const { return x; }
+	void Teleport(int where) { x = float(where); }
+
+	template<size_t N>
+	void Extra(int value) { x += float(value + int(N)); }
+};
+
+constexpr size_t ExtraCount = 32;
+std::string extraNames[ExtraCount];
+
+template<size_t ...Idx>
+void register_extra(std::index_sequence<Idx...>)
+{
+	// one batch, frozen once when it goes out of scope.
+	auto batch = Registrar<Actor>().Edit();
+	(batch.AddFunction(&Actor::Extra<Idx>, extraNames[Idx] = "Extra" + std::to_string(Idx)), ...);
+}
+
+void run(size_t count)
+{
+	Actor actor;
+	std::vector<any> oneArg{ make_ref(actor), make_copy(0.5f) };
+	std::vector<any> twoArgs{ make_ref(actor), make_copy(0.5f), make_copy(2.0f) };
+
+	epoch::Guard guard;
+	auto info = GetType<Actor>()->AsClass();
+	auto lookup = [&](const std::vector<any>& anies) -> const Member*
+	{
+		for (auto& func : info->GetFunctions())
+		{
+			if (func.name != "Move" || func.paramType.size() != anies.size() - 1)
+			{
+				continue;
+			}
+			bool match = true;
+			for (size_t i = 0; match && i < func.paramType.size(); i++)
+			{
+				match = func.paramType[i] == anies[i + 1].typeInfo_;
+			}
+			if (match)
+			{
+				return &func;
+			}
+		}
+		return nullptr;
+	};
+
+	double uncached = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			auto& anies = i % 2 ? twoArgs : oneArg;
+			lookup(anies)->call(anies);
+		}
+	});
+
+	CallSite site("Move");
+	double cached = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			site.Call(i % 2 ? twoArgs : oneArg);
+		}
+	});
+
+	std::printf("%zu calls alternating two Move overloads, %zu methods\n", count, info->GetFunctions().size());
+	std::printf("  full lookup          : %8.2f ns per call\n", uncached * 1e9 / count);
+	std::printf("  CallSite             : %8.2f ns per call, hit rate %.6f\n", cached * 1e9 / count, site.HitRate());
+	std::printf("  (%f)\n", actor.x);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 5000000);
+	for (bool extra : { false, true })
+	{
+		Registrar<Actor>().Regist("Actor");
+		if (extra)
+		{
+			register_extra(std::make_index_sequence<ExtraCount>());
+		}
+		Registrar<Actor>()
+			.AddFunction(&Actor::Reset, "Reset")
+			.AddFunction(&Actor::Get, "Get")
+			.AddFunction(&Actor::Teleport, "Teleport")
+			.AddFunction(static_cast<void(Actor::*)(float, float)>(&Actor::Move), "Move")
+			.AddFunction(static_cast<void(Actor::*)(float)>(&Actor::Move), "Move");
+		run(count);
+	}
+	return 0;
+}
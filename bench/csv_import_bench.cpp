@@ -0,0 +1,64 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Import throughput of a generated CSV file into std::vector<Trade> with 1,
+// 2 and 4 worker threads. The default is 512 MB of text rather than 5 GB so
+// the text and the rows fit in memory together; the size is argv[1] in MB.
+
+enum class Side : uint8_t
+{
+	Buy = 1,
+	Sell = 2,
+};
+
+struct Trade
+{
+	int64_t id = 0;
+	double price = 0;
+	float quantity = 0;
+	uint16_t venue = 0;
+	Side side = Side::Buy;
+	bool open = false;
+	std::string symbol;
+};
+
+BEGIN_STATIC_CLASS(Trade)
+	static_var(id)
+	static_var(price)
+	static_var(quantity)
+	static_var(venue)
+	static_var(side)
+	static_var(open)
+	static_var(symbol)
+END_STATIC_CLASS(Trade)
+
+int main(int argc, char** argv)
+{
+	size_t megabytes = Arg(argc, argv, 1, 512);
+
+	Registrar<Side>().Regist("Side").Add("Buy", Side::Buy).Add("Sell", Side::Sell);
+
+	std::string text = "id,symbol,side,price,quantity,venue,open\n";
+	text.reserve(megabytes << 20);
+	for (size_t i = 0; text.size() < megabytes << 20; i++)
+	{
+		text += std::to_string(i * 7919);
+		text += i % 3 ? ",AAPL,Buy," : ",MSFT,Sell,";
+		text += std::to_string(100 + i % 900) + "." + std::to_string(i % 100);
+		text += "," + std::to_string(i % 5000) + ".5," + std::to_string(i % 40) + (i % 2 ? ",true\n" : ",false\n");
+	}
+
+	std::printf("%.0f MB of CSV, %u hardware threads\n", text.size() / 1048576.0, std::thread::hardware_concurrency());
+	for (size_t threads : { 1, 2, 4 })
+	{
+		ThreadPool pool(threads);
+		std::vector<Trade> trades;
+		csv::Result result;
+		double seconds = Seconds([&] { result = csv::Import(text, trades, ',', pool); });
+		std::printf("  %zu threads : %7.1f ms, %5.2f GB/s, %zu rows, %zu errors\n", threads, seconds * 1e3, text.size() / seconds * 1e-9, result.rows, result.errors);
+	}
+	return 0;
+}
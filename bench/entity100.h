@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include "reflect.h"
+
+// A class with 100 int32_t members f00..f99 and a static table, for the
+// benches that need a wide class. add_fields(add) calls add(ptr, name, attrs)
+// once per member with a static_name, every fourth member is replicated.
+
+#define REPEAT10(X, p) X(p##0) X(p##1) X(p##2) X(p##3) X(p##4) X(p##5) X(p##6) X(p##7) X(p##8) X(p##9)
+#define REPEAT100(X) REPEAT10(X, 0) REPEAT10(X, 1) REPEAT10(X, 2) REPEAT10(X, 3) REPEAT10(X, 4) \
+	REPEAT10(X, 5) REPEAT10(X, 6) REPEAT10(X, 7) REPEAT10(X, 8) REPEAT10(X, 9)
+
+// 1##n keeps 08 and 09 from reading as octal.
+#define DECLARE_FIELD(n) int32_t f##n = 1##n;
+#define STATIC_FIELD(n) static_var(f##n)
+// every fourth member is replicated.
+#define ADD_FIELD(n) add(&Entity::f##n, static_name{ "f" #n }, (1##n % 4) == 0 ? attr::replicated : attr::Set{});
+
+struct Entity
+{
+	REPEAT100(DECLARE_FIELD)
+};
+
+BEGIN_STATIC_CLASS(Entity)
+	REPEAT100(STATIC_FIELD)
+END_STATIC_CLASS(Entity)
+
+template<typename Add>
+void add_fields(Add&& add)
+{
+	REPEAT100(ADD_FIELD)
+}
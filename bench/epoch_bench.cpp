@@ -0,0 +1,72 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Reader cost of a guarded member walk, alone and while a writer keeps
+// registering the class again, plus the cost of one batched registration.
+
+struct Sample
+{
+	int a;
+	float b;
+	double c;
+};
+
+void regist()
+{
+	Registrar<Sample>().Regist("Sample")
+		.AddVariable(&Sample::a, "a")
+		.AddVariable(&Sample::b, "b")
+		.AddVariable(&Sample::c, "c");
+}
+
+size_t walk(size_t iterations)
+{
+	size_t sum = 0;
+	auto info = GetType<Sample>()->AsClass();
+	for (size_t i = 0; i < iterations; i++)
+	{
+		epoch::Guard guard;
+		for (auto& var : info->Current().GetVariable())
+		{
+			sum += var.name.size();
+		}
+	}
+	return sum;
+}
+
+int main(int argc, char** argv)
+{
+	size_t iterations = Arg(argc, argv, 1, 10000000);
+	size_t reloads = Arg(argc, argv, 2, 100000);
+
+	regist();
+	size_t sum = 0;
+	double quiet = Seconds([&] { sum += walk(iterations); });
+
+	std::atomic<bool> done{ false };
+	std::atomic<size_t> published{ 0 };
+	std::thread writer([&]
+	{
+		while (!done.load(std::memory_order_relaxed))
+		{
+			regist();
+			published.fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+	double busy = Seconds([&] { sum += walk(iterations); });
+	done.store(true);
+	writer.join();
+
+	double batches = Seconds([&] { for (size_t i = 0; i < reloads; i++) regist(); });
+	epoch::Domain::Instance().Reclaim();
+
+	std::printf("%zu guarded walks of 3 members\n", iterations);
+	std::printf("  no writer            : %8.2f ns per walk\n", quiet * 1e9 / iterations);
+	std::printf("  writer reloading     : %8.2f ns per walk, %zu versions published meanwhile\n", busy * 1e9 / iterations, published.load());
+	std::printf("  registration         : %8.2f us per 3 member batch, one publish each\n", batches * 1e6 / reloads);
+	std::printf("  pending after reclaim: %zu (%zu)\n", epoch::Domain::Instance().Pending(), sum);
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Reflective calls with a 1 KB std::string argument: a const std::string&
+// parameter is bound to the payload, a by value parameter has to copy it.
+// Heap allocations are counted to show the copy, or its absence.
+
+static std::atomic<size_t> allocations{ 0 };
+
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+struct Logger
+{
+	size_t bytes = 0;
+
+	void ByConstRef(const std::string& text) { bytes += text.size(); }
+	void ByValue(std::string text) { bytes += text.size(); }
+};
+
+template<typename F>
+void run(const char* name, size_t count, F&& f)
+{
+	size_t before = allocations.load();
+	double seconds = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			f();
+		}
+	});
+	double perCall = double(allocations.load() - before) / count;
+	std::printf("  %-22s : %7.1f ns, %.2f allocations per call\n", name, seconds / count * 1e9, perCall);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 2000000);
+
+	Registrar<Logger>().Regist("Logger")
+		.AddFunction(&Logger::ByConstRef, "ByConstRef")
+		.AddFunction(&Logger::ByValue, "ByValue");
+
+	const Class* info = GetType<Logger>()->AsClass();
+	auto& byConstRef = info->GetFunctions()[info->FindFunction("ByConstRef")];
+	auto& byValue = info->GetFunctions()[info->FindFunction("ByValue")];
+
+	Logger logger;
+	std::string text(1024, 'x');
+	std::vector<any> args{ make_ref(logger), make_cref(text) };
+
+	std::printf("%zu calls with a 1 KB string\n", count);
+	run("const std::string&", count, [&] { byConstRef.call(args); });
+	run("std::string by value", count, [&] { byValue.call(args); });
+	std::printf("(%zu)\n", logger.bytes);
+	return 0;
+}
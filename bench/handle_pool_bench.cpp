@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Resolving ids to objects and walking every live object: HandlePool
+// against heap objects in a std::unordered_map keyed by id, after a third
+// of the objects were destroyed and recreated.
+
+struct Particle
+{
+	float x = 0, y = 0, vx = 1, vy = 1;
+};
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 500000);
+	size_t lookups = Arg(argc, argv, 2, 10000000);
+
+	auto& pool = HandlePool<Particle>::Instance();
+	std::vector<Handle> handles;
+	std::unordered_map<uint32_t, Particle*> map;
+	std::vector<uint32_t> ids;
+	for (size_t i = 0; i < count; i++)
+	{
+		handles.push_back(pool.Create());
+		map.emplace(static_cast<uint32_t>(i), new Particle());
+		ids.push_back(static_cast<uint32_t>(i));
+	}
+	for (size_t i = 0; i < count; i += 3)
+	{
+		pool.Destroy(handles[i]);
+		handles[i] = pool.Create();
+		delete map[ids[i]];
+		map.erase(ids[i]);
+		ids[i] = static_cast<uint32_t>(count + i);
+		map.emplace(ids[i], new Particle());
+	}
+
+	std::vector<uint32_t> order(lookups);
+	uint32_t state = 12345;
+	for (auto& idx : order)
+	{
+		state = state * 1664525u + 1013904223u;
+		idx = (state >> 8) % count;
+	}
+
+	float sum = 0;
+	double poolResolve = Seconds([&] { for (uint32_t idx : order) sum += pool.Get(handles[idx])->x; });
+	double mapResolve = Seconds([&] { for (uint32_t idx : order) sum += map.find(ids[idx])->second->x; });
+
+	size_t passes = 20;
+	double poolIterate = Seconds([&]
+	{
+		for (size_t pass = 0; pass < passes; pass++)
+		{
+			for (auto& p : pool)
+			{
+				p.x += p.vx;
+			}
+		}
+	});
+	double mapIterate = Seconds([&]
+	{
+		for (size_t pass = 0; pass < passes; pass++)
+		{
+			for (auto& entry : map)
+			{
+				entry.second->x += entry.second->vx;
+			}
+		}
+	});
+
+	std::printf("%zu objects, %zu random resolves, %zu full passes\n", count, lookups, passes);
+	std::printf("  resolve  : HandlePool %6.2f ns, unordered_map %6.2f ns\n", poolResolve / lookups * 1e9, mapResolve / lookups * 1e9);
+	std::printf("  iterate  : HandlePool %6.2f ns, unordered_map %6.2f ns per object\n", poolIterate / (passes * count) * 1e9, mapIterate / (passes * count) * 1e9);
+	std::printf("(%g)\n", double(sum));
+	for (auto& entry : map)
+	{
+		delete entry.second;
+	}
+	return 0;
+}
@@ -0,0 +1,42 @@
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+#include "entity100.h"
+
+// Registration time of 10k members, 100 batches of the 100 member Entity:
+// names given as static_name, kept as views, against run time std::string
+// names, which the batch copies until it is frozen.
+
+int main(int argc, char** argv)
+{
+	size_t rounds = Arg(argc, argv, 1, 100);
+
+	std::vector<std::string> loaded;
+	add_fields([&](auto, static_name name, attr::Set) { loaded.emplace_back(name.value); });
+
+	double kept = Seconds([&]
+	{
+		for (size_t i = 0; i < rounds; i++)
+		{
+			auto batch = Registrar<Entity>().Regist("Entity");
+			add_fields([&](auto ptr, static_name name, attr::Set attrs) { batch.AddVariable(ptr, name, attrs); });
+		}
+	});
+
+	double copied = Seconds([&]
+	{
+		for (size_t i = 0; i < rounds; i++)
+		{
+			size_t idx = 0;
+			auto batch = Registrar<Entity>().Regist("Entity");
+			add_fields([&](auto ptr, static_name, attr::Set attrs) { batch.AddVariable(ptr, loaded[idx++], attrs); });
+		}
+	});
+
+	size_t members = rounds * loaded.size();
+	std::printf("%zu members in %zu batches\n", members, rounds);
+	std::printf("  static_name, kept   : %6.1f ns per member\n", kept / members * 1e9);
+	std::printf("  std::string, copied : %6.1f ns per member\n", copied / members * 1e9);
+	return 0;
+}
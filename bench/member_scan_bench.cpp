@@ -0,0 +1,161 @@
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+#include "entity100.h"
+
+// Cache lines a full member scan of a 100 member class touches, counted from
+// the addresses the scan reads, and its time when the metadata is not cached:
+// the MemberTable against the storage it replaced, a std::vector of
+// MemberVariable plus a parallel attribute vector. Two scans: an attribute
+// filter (type and attributes) and a lookup by name.
+
+struct OldLayout
+{
+	std::vector<MemberVariable> vars;
+	std::vector<uint32_t> attrs;
+};
+
+// distinct 64 byte lines under the [address, address + size) ranges read.
+template<typename Each>
+size_t count_lines(Each&& each)
+{
+	std::set<uintptr_t> lines;
+	each([&](const void* address, size_t size)
+	{
+		uintptr_t begin = reinterpret_cast<uintptr_t>(address);
+		for (uintptr_t line = begin / 64; line <= (begin + size - 1) / 64; line++)
+		{
+			lines.insert(line);
+		}
+	});
+	return lines.size();
+}
+
+int main(int argc, char** argv)
+{
+	size_t copies = Arg(argc, argv, 1, 4000);
+	size_t passes = Arg(argc, argv, 2, 20);
+
+	{
+		auto batch = Registrar<Entity>().Regist("Entity");
+		add_fields([&](auto ptr, static_name name, attr::Set attrs) { batch.AddVariable(ptr, name, attrs); });
+	}
+
+	epoch::Guard guard;
+	const Class* info = GetType<Entity>()->AsClass();
+	auto& table = info->GetMembers();
+	std::vector<MemberVariable> vars(table.Objects().begin(), table.Objects().end());
+
+	// many copies of both layouts, together far larger than the caches.
+	std::vector<OldLayout> olds(copies);
+	std::vector<MemberTable> news(copies);
+	for (size_t c = 0; c < copies; c++)
+	{
+		olds[c].vars = vars;
+		for (auto& record : table)
+		{
+			olds[c].attrs.push_back(record.attrs);
+		}
+		news[c] = MemberTable::Build(vars, [&](size_t idx) { return table[idx]; }, [&](size_t idx) { return table.GetCold(idx).range; });
+	}
+
+	auto& old = olds[0];
+	auto& packed = news[0];
+	size_t oldFilterLines = count_lines([&](auto read)
+	{
+		for (size_t i = 0; i < old.vars.size(); i++)
+		{
+			read(&old.vars[i].type, sizeof(const Type*));
+			read(&old.attrs[i], sizeof(uint32_t));
+		}
+	});
+	size_t newFilterLines = count_lines([&](auto read)
+	{
+		for (auto& record : packed)
+		{
+			read(&record, sizeof(record));
+		}
+	});
+	size_t oldNameLines = count_lines([&](auto read)
+	{
+		for (auto& var : old.vars)
+		{
+			read(&var.name, sizeof(var.name));
+			read(var.name.data(), var.name.size());
+		}
+	});
+	size_t newNameLines = count_lines([&](auto read)
+	{
+		for (size_t i = 0; i < packed.size(); i++)
+		{
+			auto& cold = packed.GetCold(i);
+			read(&cold, sizeof(cold));
+			read(cold.name.data(), cold.name.size());
+		}
+	});
+
+	size_t found = 0;
+	double oldFilter = Seconds([&]
+	{
+		for (size_t p = 0; p < passes; p++)
+		{
+			for (auto& layout : olds)
+			{
+				for (size_t i = 0; i < layout.vars.size(); i++)
+				{
+					found += layout.vars[i].type != nullptr && (layout.attrs[i] & attr::Replicated);
+				}
+			}
+		}
+	});
+	double newFilter = Seconds([&]
+	{
+		for (size_t p = 0; p < passes; p++)
+		{
+			for (auto& members : news)
+			{
+				for (auto& record : members)
+				{
+					found += record.type != nullptr && (record.attrs & attr::Replicated);
+				}
+			}
+		}
+	});
+	double oldName = Seconds([&]
+	{
+		for (size_t p = 0; p < passes; p++)
+		{
+			for (auto& layout : olds)
+			{
+				for (auto& var : layout.vars)
+				{
+					found += var.name == "f99";
+				}
+			}
+		}
+	});
+	double newName = Seconds([&]
+	{
+		for (size_t p = 0; p < passes; p++)
+		{
+			for (auto& members : news)
+			{
+				for (size_t i = 0; i < members.size(); i++)
+				{
+					found += members.GetCold(i).name == "f99";
+				}
+			}
+		}
+	});
+
+	double scans = double(passes * copies);
+	std::printf("100 members, %zu copies of each layout\n", copies);
+	std::printf("  attribute scan, vector<MemberVariable> : %4zu lines %8.1f ns\n", oldFilterLines, oldFilter / scans * 1e9);
+	std::printf("  attribute scan, MemberTable            : %4zu lines %8.1f ns\n", newFilterLines, newFilter / scans * 1e9);
+	std::printf("  name scan,      vector<MemberVariable> : %4zu lines %8.1f ns\n", oldNameLines, oldName / scans * 1e9);
+	std::printf("  name scan,      MemberTable            : %4zu lines %8.1f ns\n", newNameLines, newName / scans * 1e9);
+	std::printf("(%zu)\n", found);
+	return 0;
+}
@@ -0,0 +1,73 @@
+#define REFLECT_MEMORY_STATS
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Cost of the accounting on the payload path: make_copy/release of a boxed
+// payload with REFLECT_MEMORY_STATS on, and the sharded counter against one
+// shared pair of atomics under several threads.
+
+struct Blob
+{
+	char bytes[128];
+};
+
+template<typename F>
+double threaded(size_t threads, F&& f)
+{
+	return Seconds([&]
+	{
+		std::vector<std::thread> workers;
+		for (size_t t = 0; t < threads; t++)
+		{
+			workers.emplace_back(f);
+		}
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	});
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 2000000);
+	size_t threads = Arg(argc, argv, 2, 4);
+
+	Blob blob{};
+	double boxed = threaded(threads, [&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			any value = make_copy(blob);
+		}
+	});
+
+	memstats::Counter sharded;
+	double shardedTime = threaded(threads, [&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			sharded.Add(1, 128);
+		}
+	});
+
+	std::atomic<int64_t> sharedCount{ 0 }, sharedBytes{ 0 };
+	double sharedTime = threaded(threads, [&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			sharedCount.fetch_add(1, std::memory_order_relaxed);
+			sharedBytes.fetch_add(128, std::memory_order_relaxed);
+		}
+	});
+
+	size_t total = count * threads;
+	std::printf("%zu threads x %zu, %u hardware threads\n", threads, count, std::thread::hardware_concurrency());
+	std::printf("  make_copy + release  : %8.2f ns per payload, stats on\n", boxed * 1e9 / total);
+	std::printf("  sharded counter      : %8.2f ns per add (%lld)\n", shardedTime * 1e9 / total, (long long)sharded.Read().count);
+	std::printf("  one shared atomic    : %8.2f ns per add (%lld)\n", sharedTime * 1e9 / total, (long long)sharedCount.load());
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <atomic>
+#include <cstdint>
+#include "reflect.h"
+#include "bench.h"
+
+// Messages per second through Class::Dispatch: packed with the compile time
+// checked PackArgs, with the run time checked one, and posted through a
+// MessagePump drained by 1, 2 and 4 consumers.
+
+struct Account
+{
+	std::atomic<int64_t> balance{ 0 };
+
+	void Deposit(int64_t amount, uint8_t times) { balance.fetch_add(amount * times, std::memory_order_relaxed); }
+};
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 4000000);
+
+	Registrar<Account>().Regist("Account").AddFunction(&Account::Deposit, "Deposit");
+	const Class* info = GetType<Account>()->AsClass();
+
+	Account account;
+	Message message;
+	message.info = info;
+	message.obj = &account;
+	message.methodId = info->FindFunction("Deposit");
+
+	double typed = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			PackArgs(message, &Account::Deposit, int64_t(i), uint8_t(1));
+			info->Dispatch(&account, message.methodId, message.args);
+		}
+	});
+
+	double checked = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			PackArgs(message, int64_t(i), uint8_t(1));
+			info->Dispatch(&account, message.methodId, message.args);
+		}
+	});
+
+	std::printf("%zu messages\n", count);
+	std::printf("  typed PackArgs + Dispatch   : %8.2f M/s\n", count / typed * 1e-6);
+	std::printf("  checked PackArgs + Dispatch : %8.2f M/s\n", count / checked * 1e-6);
+
+	for (size_t consumers : { 1, 2, 4 })
+	{
+		size_t posted = count / 4;
+		double pumped = Seconds([&]
+		{
+			MessagePump pump(consumers);
+			for (size_t i = 0; i < posted; i++)
+			{
+				PackArgs(message, &Account::Deposit, int64_t(1), uint8_t(1));
+				while (!pump.Post(message))
+				{
+					std::this_thread::yield();
+				}
+			}
+			while (pump.Processed() + pump.Rejected() < posted)
+			{
+				std::this_thread::yield();
+			}
+		});
+		std::printf("  MessagePump, %zu consumers    : %8.2f M/s\n", consumers, posted / pumped * 1e-6);
+	}
+	std::printf("(%lld)\n", static_cast<long long>(account.balance.load()));
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Migrating 10M stored records to a changed class: building the plan once,
+// running it, and a hand written conversion loop as the floor.
+
+struct StoredItem
+{
+	int32_t id;
+	float weight;
+	int16_t level;
+	uint8_t count;
+	uint8_t flags;
+	double dropped;
+};
+
+struct Item
+{
+	double weight = 0;
+	int64_t id = 0;
+	int32_t level = 0;
+	uint16_t added = 7;
+	uint8_t count = 0;
+	uint8_t flags = 0;
+};
+
+BEGIN_STATIC_CLASS(StoredItem)
+	static_var(id)
+	static_var(weight)
+	static_var(level)
+	static_var(count)
+	static_var(flags)
+	static_var(dropped)
+END_STATIC_CLASS(StoredItem)
+
+BEGIN_STATIC_CLASS(Item)
+	static_var(weight)
+	static_var(id)
+	static_var(level)
+	static_var(added)
+	static_var(count)
+	static_var(flags)
+END_STATIC_CLASS(Item)
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 10000000);
+
+	std::vector<StoredItem> records(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		records[i] = StoredItem{ int32_t(i), float(i), int16_t(i), uint8_t(i), uint8_t(i >> 8), 1.0 };
+	}
+	std::vector<Item> items(count);
+
+	auto file = snapshot::Writer().AddClass(GetStaticType<StoredItem>()).Build();
+	snapshot::View view(file.data(), file.size());
+
+	migrate::Plan plan;
+	double build = Seconds([&] { plan = migrate::Plan::Build<Item>(view, *view.FindClass("StoredItem")); });
+	auto checksum = [&]
+	{
+		double sum = 0;
+		for (auto& item : items)
+		{
+			sum += item.weight + double(item.id) + item.level + item.added + item.count + item.flags;
+		}
+		return sum;
+	};
+
+	double run = Seconds([&] { plan.Run(records.data(), count, items.data()); });
+	double planSum = checksum();
+	items.assign(count, Item{});
+	double hand = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			auto& src = records[i];
+			items[i] = Item{ double(src.weight), int64_t(src.id), int32_t(src.level), 7, src.count, src.flags };
+		}
+	});
+
+	double bytes = double(count) * (sizeof(StoredItem) + sizeof(Item));
+	std::printf("%zu records, %zu steps\n", count, plan.GetSteps().size());
+	std::printf("  build plan   : %8.3f us\n", build * 1e6);
+	std::printf("  run plan     : %8.1f ms, %6.1f M records/s, %5.2f GB/s read+written\n", run * 1e3, count / run * 1e-6, bytes / run * 1e-9);
+	std::printf("  hand written : %8.1f ms, %6.1f M records/s\n", hand * 1e3, count / hand * 1e-6);
+	std::printf("(%s)\n", planSum == checksum() ? "same result" : "DIFFERENT");
+	return 0;
+}
@@ -0,0 +1,48 @@
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include "function_traits.h"
+#include "packed_layout.h"
+#include "bench.h"
+
+// Argument buffer sizes of typical method signatures: std::tuple of the
+// decayed parameters, in declaration order, against packed_tuple.
+
+struct Vec3
+{
+	float x, y, z;
+};
+
+struct Api
+{
+	void SetFlag(bool, double, int) {}
+	void Move(uint8_t, double, uint16_t, float) {}
+	void Hit(int64_t, char, int, bool, double) {}
+	void Spawn(bool, Vec3, uint64_t, uint8_t) {}
+	void Log(char, const std::string&, int) {}
+	void Resize(uint16_t, uint64_t, uint16_t, uint32_t) {}
+	void Tick(double) {}
+	void Pair(int, int) {}
+};
+
+template<typename Ptr>
+void report(const char* name, Ptr)
+{
+	using declared = typename detail::decay_tuple<typename function_traits<Ptr>::args>::type;
+	using packed = packed_args_t<function_traits<Ptr>>;
+	std::printf("  %-8s : std::tuple %3zu bytes, packed_tuple %3zu bytes\n", name, sizeof(declared), sizeof(packed));
+}
+
+int main()
+{
+	std::printf("argument buffer sizes\n");
+	report("SetFlag", &Api::SetFlag);
+	report("Move", &Api::Move);
+	report("Hit", &Api::Hit);
+	report("Spawn", &Api::Spawn);
+	report("Log", &Api::Log);
+	report("Resize", &Api::Resize);
+	report("Tick", &Api::Tick);
+	report("Pair", &Api::Pair);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Payload allocation throughput with 1 to 32 threads, each allocating and
+// freeing 64 byte blocks through payload::Pool and through operator new.
+// Then a producer/consumer pipeline where every payload is freed on another
+// thread, with the resident set size before and after.
+
+size_t resident_kb()
+{
+	size_t pages = 0, resident = 0;
+	if (FILE* fp = std::fopen("/proc/self/statm", "r"))
+	{
+		if (std::fscanf(fp, "%zu %zu", &pages, &resident) != 2)
+		{
+			resident = 0;
+		}
+		std::fclose(fp);
+	}
+	return resident * 4;
+}
+
+template<typename Alloc, typename Free>
+double churn(size_t threads, size_t perThread, Alloc alloc, Free release)
+{
+	return Seconds([&]
+	{
+		std::vector<std::thread> workers;
+		for (size_t t = 0; t < threads; t++)
+		{
+			workers.emplace_back([&]
+			{
+				void* live[64];
+				for (size_t i = 0; i < perThread; i += 64)
+				{
+					for (auto& block : live)
+					{
+						block = alloc();
+					}
+					for (auto& block : live)
+					{
+						release(block);
+					}
+				}
+			});
+		}
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	});
+}
+
+struct Record
+{
+	char bytes[200];
+};
+
+int main(int argc, char** argv)
+{
+	size_t total = Arg(argc, argv, 1, 32000000);
+
+	std::printf("%zu allocations of 64 bytes split over the threads, %u hardware threads\n", total, std::thread::hardware_concurrency());
+	for (size_t threads : { 1, 4, 32 })
+	{
+		double pool = churn(threads, total / threads, [] { return payload::Pool::Allocate(64, 8); }, [](void* p) { payload::Pool::Deallocate(p, 64, 8); });
+		double global = churn(threads, total / threads, [] { return ::operator new(64); }, [](void* p) { ::operator delete(p); });
+		std::printf("  %2zu threads : Pool %6.2f ns, operator new %6.2f ns per allocation + free\n", threads, pool / total * 1e9, global / total * 1e9);
+	}
+
+	size_t count = total / 4;
+	size_t before = resident_kb();
+	double pipeline = Seconds([&]
+	{
+		mpmc_queue<any> queue(4096);
+		std::atomic<bool> done{ false };
+		std::thread consumer([&]
+		{
+			any value;
+			while (!done.load(std::memory_order_acquire) || queue.try_pop(value))
+			{
+				if (queue.try_pop(value))
+				{
+					value = any();
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+		Record record{};
+		for (size_t i = 0; i < count; i++)
+		{
+			while (!queue.try_push(make_copy(record)))
+			{
+				std::this_thread::yield();
+			}
+		}
+		done.store(true, std::memory_order_release);
+		consumer.join();
+	});
+	std::printf("producer/consumer, %zu payloads of 200 bytes freed on the other thread\n", count);
+	std::printf("  %6.1f ns per payload, resident %zu KB before, %zu KB after, %zu slabs held\n", pipeline / count * 1e9, before, resident_kb(), payload::Pool::SlabCount());
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// height > 1.8 && isFemale over N rows: a tree walk that boxes every field
+// through the reflected getter per row, against the compiled batch program.
+
+struct Person
+{
+	std::string familyName;
+	float height;
+	bool isFemale;
+};
+
+BEGIN_STATIC_CLASS(Person)
+	static_var(familyName)
+	static_var(height)
+	static_var(isFemale)
+END_STATIC_CLASS(Person)
+
+// the naive form: one any per leaf and row, the kind decided per value.
+struct Interpreter
+{
+	const Class& info;
+	std::vector<any> args = std::vector<any>(1);
+
+	double number(const any& value)
+	{
+		auto numeric = value.typeInfo_->AsNumeric();
+		switch (numeric->GetKind())
+		{
+		case Numeric::Kind::Float:
+			return *try_cast<float>(value);
+		case Numeric::Kind::Double:
+			return *try_cast<double>(value);
+		default:
+			return value.typeInfo_ == GetType<bool>() ? *try_cast<bool>(value) : 0.0;
+		}
+	}
+
+	bool eval(const query::Node& node, Person& row)
+	{
+		using Kind = query::Node::Kind;
+		switch (node.kind)
+		{
+		case Kind::And:
+			return eval(*node.lhs, row) && eval(*node.rhs, row);
+		case Kind::Or:
+			return eval(*node.lhs, row) || eval(*node.rhs, row);
+		case Kind::Not:
+			return !eval(*node.lhs, row);
+		default:
+			break;
+		}
+
+		for (auto& var : info.GetVariable())
+		{
+			if (var.name == node.name)
+			{
+				args[0] = make_ref(row);
+				double lhs = number(var.call(args));
+				double rhs = node.value.real;
+				switch (node.op)
+				{
+				case query::Op::Less: return lhs < rhs;
+				case query::Op::LessEqual: return lhs <= rhs;
+				case query::Op::Greater: return lhs > rhs;
+				case query::Op::GreaterEqual: return lhs >= rhs;
+				case query::Op::Equal: return lhs == rhs;
+				case query::Op::NotEqual: return lhs != rhs;
+				}
+			}
+		}
+		return false;
+	}
+};
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 1000000);
+
+	Registrar<Person>().Regist("Person")
+		.AddVariable(&Person::familyName, "familyName")
+		.AddVariable(&Person::height, "height")
+		.AddVariable(&Person::isFemale, "isFemale");
+
+	std::vector<Person> people(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		people[i].height = 1.5f + float(i % 50) * 0.01f;
+		people[i].isFemale = i % 3 == 0;
+	}
+
+	auto& info = GetStaticType<Person>();
+	auto pred = query::Field(info, "height") > 1.8 && query::Field(info, "isFemale");
+
+	epoch::Guard guard;
+	Interpreter interpreter{ *GetType<Person>()->AsClass() };
+	size_t naive = 0;
+	double naiveTime = Seconds([&]
+	{
+		for (auto& person : people)
+		{
+			naive += interpreter.eval(pred.GetNode(), person);
+		}
+	});
+
+	std::vector<uint32_t> rows;
+	double compiledTime = Seconds([&] { rows = query::Compile(pred).Filter(people.data(), people.size()); });
+
+	std::printf("height > 1.8 && isFemale over %zu rows\n", count);
+	std::printf("  boxed interpreter    : %8.2f ns per row\n", naiveTime * 1e9 / count);
+	std::printf("  compiled             : %8.2f ns per row, %.1fx (%zu and %zu rows)\n", compiledTime * 1e9 / count, naiveTime / compiledTime, naive, rows.size());
+	return 0;
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+#include "entity100.h"
+
+// Serializing the replicated members of a 100 member class, one in four is
+// replicated: walking the cached GetVariable(attr::Replicated) list against
+// testing the attribute of every member on every pass. Also the cost of
+// registering the 100 members as 100 factory calls against one batch.
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 1000000);
+	size_t rounds = Arg(argc, argv, 2, 200);
+
+	double single = Seconds([&]
+	{
+		for (size_t i = 0; i < rounds; i++)
+		{
+			Registrar<Entity>().Regist("Entity");
+			add_fields([](auto ptr, static_name name, attr::Set attrs) { Registrar<Entity>().AddVariable(ptr, name, attrs); });
+		}
+	});
+
+	double batched = Seconds([&]
+	{
+		for (size_t i = 0; i < rounds; i++)
+		{
+			auto batch = Registrar<Entity>().Regist("Entity");
+			add_fields([&](auto ptr, static_name name, attr::Set attrs) { batch.AddVariable(ptr, name, attrs); });
+		}
+	});
+
+	epoch::Domain::Instance().Reclaim();
+	epoch::Guard guard;
+	const Class* info = GetType<Entity>()->AsClass();
+	auto& members = info->GetMembers();
+	auto& slots = info->GetVisitSlots();
+	auto& replicated = info->GetVariable(attr::Replicated);
+
+	std::vector<Entity> entities(64);
+	std::vector<unsigned char> buffer(sizeof(Entity));
+	uint64_t sum = 0;
+
+	double filtered = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			auto object = reinterpret_cast<const unsigned char*>(&entities[i & 63]);
+			unsigned char* out = buffer.data();
+			for (size_t m = 0; m < members.size(); m++)
+			{
+				if (members[m].attrs & attr::Replicated)
+				{
+					std::memcpy(out, object + members[m].offset, slots[m].size);
+					out += slots[m].size;
+				}
+			}
+			sum += out - buffer.data() + buffer[i & 7];
+		}
+	});
+
+	double cached = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			auto object = reinterpret_cast<const unsigned char*>(&entities[i & 63]);
+			unsigned char* out = buffer.data();
+			for (uint32_t m : replicated)
+			{
+				std::memcpy(out, object + members[m].offset, slots[m].size);
+				out += slots[m].size;
+			}
+			sum += out - buffer.data() + buffer[i & 7];
+		}
+	});
+
+	std::printf("%zu members, %zu replicated\n", members.size(), replicated.size());
+	std::printf("  register, 100 factory calls : %8.1f us\n", single / rounds * 1e6);
+	std::printf("  register, one batch         : %8.1f us\n", batched / rounds * 1e6);
+	std::printf("%zu serializations\n", count);
+	std::printf("  filter every member         : %8.1f ns\n", filtered / count * 1e9);
+	std::printf("  GetVariable(Replicated)     : %8.1f ns\n", cached / count * 1e9);
+	std::printf("(%llu)\n", static_cast<unsigned long long>(sum));
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// A copy heavy pipeline: argument lists holding a 4 KB reflected object are
+// passed by value through several stages, one stage in ten writes to it.
+// Copy payloads deep copy at every hop, Shared payloads bump a count and
+// only copy on the write.
+
+struct Frame
+{
+	float samples[1024] = {};
+};
+
+std::vector<any> stage(std::vector<any> args, bool write)
+{
+	if (write)
+	{
+		try_cast<Frame>(args[0])->samples[0] += 1;
+	}
+	return args;
+}
+
+template<typename Make>
+double run(size_t count, size_t depth, Make make)
+{
+	double sink = 0;
+	double seconds = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			std::vector<any> args{ make(), make_copy(int(i)) };
+			for (size_t hop = 0; hop < depth; hop++)
+			{
+				std::vector<any> copy = args;
+				args = stage(copy, hop % 10 == 9);
+			}
+			sink += try_cast<Frame>(static_cast<const any&>(args[0]))->samples[0];
+		}
+	});
+	return sink >= 0 ? seconds : -seconds;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 20000);
+	size_t depth = 20;
+
+	Frame frame;
+	double copies = run(count, depth, [&] { return make_copy(frame); });
+	double shared = run(count, depth, [&] { return make_share(Frame(frame)); });
+
+	any one = make_share(Frame(frame));
+	size_t copiesOfOne = 10000000;
+	double share = Seconds([&]
+	{
+		for (size_t i = 0; i < copiesOfOne; i++)
+		{
+			any copy = one;
+		}
+	});
+
+	std::printf("%zu pipelines of %zu hops, a 4 KB payload, a write every 10 hops\n", count, depth);
+	std::printf("  Copy payload   : %8.1f ms, %6.0f ns per hop\n", copies * 1e3, copies / (count * depth) * 1e9);
+	std::printf("  Shared payload : %8.1f ms, %6.0f ns per hop\n", shared * 1e3, shared / (count * depth) * 1e9);
+	std::printf("  copying one Shared any: %.1f ns\n", share / copiesOfOne * 1e9);
+	return 0;
+}
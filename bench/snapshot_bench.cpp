@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Open to first query for a snapshot of a 50k member registry: 1000 classes
+// of 50 members each, saved to disk, then mapped, checked and queried.
+// Validation walks every record once, the query is one binary search.
+
+struct FakeVariable
+{
+	std::string name;
+	size_t offset;
+	size_t size = 4;
+	size_t align = 4;
+
+	const Type* type() const { return GetType<int>(); }
+};
+
+struct FakeClass
+{
+	std::string name;
+	size_t size;
+	size_t align = 4;
+	std::vector<FakeVariable> variables;
+
+	const std::vector<FakeVariable>& GetVariable() const { return variables; }
+};
+
+int main(int argc, char** argv)
+{
+	size_t classCount = Arg(argc, argv, 1, 1000);
+	size_t memberCount = Arg(argc, argv, 2, 50);
+
+	snapshot::Writer writer;
+	for (size_t i = 0; i < classCount; i++)
+	{
+		FakeClass info{ "Class" + std::to_string(i), memberCount * 4, 4, {} };
+		for (size_t j = 0; j < memberCount; j++)
+		{
+			info.variables.push_back(FakeVariable{ "member" + std::to_string(j), j * 4 });
+		}
+		writer.AddClass(info);
+	}
+
+	std::string path = "snapshot_bench.bin";
+	double save = Seconds([&] { writer.Save(path); });
+
+	const snapshot::MemberRecord* found = nullptr;
+	snapshot::MappedFile file;
+	double open = 0;
+	double query = 0;
+	size_t rounds = 20;
+	for (size_t round = 0; round < rounds; round++)
+	{
+		file.Close();
+		open += Seconds([&] { file.Open(path); });
+		query += Seconds([&]
+		{
+			auto view = file.GetView();
+			auto info = view.FindClass("Class" + std::to_string(classCount / 2));
+			found = info ? view.FindVariable(*info, "member7") : nullptr;
+		});
+	}
+
+	std::printf("%zu classes x %zu members\n", classCount, memberCount);
+	std::printf("  save             : %8.3f ms\n", save * 1e3);
+	std::printf("  open + validate  : %8.3f ms (warm page cache)\n", open / rounds * 1e3);
+	std::printf("  first query      : %8.3f us (%s)\n", query / rounds * 1e6, found ? "found" : "missing");
+
+	bool valid = false;
+	double validate = Seconds([&] { valid = file.GetView().IsValid(); });
+	std::printf("  validate alone   : %8.3f ms, mapped pages resident (%s)\n", validate * 1e3, valid ? "valid" : "invalid");
+	file.Close();
+	std::remove(path.c_str());
+	return 0;
+}
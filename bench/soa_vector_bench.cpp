@@ -0,0 +1,85 @@
+#include <string>
+#include <tuple>
+#include <vector>
+#include "soa_vector.h"
+#include "bench.h"
+
+// Sum one float field across N elements stored as std::vector<T> (AoS) and as
+// soa_vector<T>, and time filling soa_vector one append at a time.
+
+struct Person
+{
+	std::string familyName;
+	float height;
+	bool isFemale;
+	double weight;
+	int age;
+};
+
+template<typename Ptr>
+struct column_of
+{
+	Ptr pointer;
+};
+
+template<typename Ptr>
+column_of(Ptr) -> column_of<Ptr>;
+
+template<>
+struct TypeInfo<Person>
+{
+	static constexpr auto variables = std::make_tuple(column_of{ &Person::familyName }, column_of{ &Person::height }, column_of{ &Person::isFemale }, column_of{ &Person::weight }, column_of{ &Person::age });
+};
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 10000000);
+	size_t repeat = Arg(argc, argv, 2, 10);
+
+	std::vector<Person> aos(count);
+	soa_vector<Person> soa;
+	double fill = Seconds([&]
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			Person person{ {}, float(i % 100) * 0.01f + 1.0f, false, 70.0, int(i % 90) };
+			aos[i] = person;
+			soa.append(&person, 1);
+		}
+	});
+
+	// a float sum is an ordered reduction the compiler may not reorder, an
+	// integer sum is free to vectorize.
+	auto run = [&](auto ptr, auto zero, const char* what)
+	{
+		auto aosSum = zero, soaSum = zero;
+		double aosTime = Seconds([&]
+		{
+			for (size_t r = 0; r < repeat; r++)
+			{
+				for (auto& person : aos)
+				{
+					aosSum += person.*decltype(ptr)::value;
+				}
+			}
+		});
+		double soaTime = Seconds([&]
+		{
+			for (size_t r = 0; r < repeat; r++)
+			{
+				for (auto value : soa.template column<decltype(ptr)::value>())
+				{
+					soaSum += value;
+				}
+			}
+		});
+		std::printf("  %-6s std::vector<T> : %8.3f ms per pass\n", what, aosTime * 1e3 / repeat);
+		std::printf("  %-6s soa_vector<T>  : %8.3f ms per pass, %.1fx (%s)\n", what, soaTime * 1e3 / repeat, aosTime / soaTime, aosSum == soaSum ? "same sum" : "SUM DIFFERS");
+	};
+
+	std::printf("%zu elements, sizeof(Person) %zu, %zu passes\n", count, sizeof(Person), repeat);
+	run(std::integral_constant<float Person::*, &Person::height>(), 0.0, "height");
+	run(std::integral_constant<int Person::*, &Person::age>(), int64_t(0), "age");
+	std::printf("  append one at a time  : %8.2f ns per element, both containers\n", fill * 1e9 / count);
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Order N records by a member chosen at run time: std::sort calling the
+// reflected getter in the comparator (two any per comparison) against
+// BuildIndex, which extracts radix keys once and sorts those.
+
+struct Person
+{
+	std::string familyName;
+	float height;
+	bool isFemale;
+};
+
+BEGIN_STATIC_CLASS(Person)
+	static_var(familyName)
+	static_var(height)
+	static_var(isFemale)
+END_STATIC_CLASS(Person)
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 10000000);
+	size_t boxedCount = Arg(argc, argv, 2, count);
+
+	Registrar<Person>().Regist("Person")
+		.AddVariable(&Person::familyName, "familyName")
+		.AddVariable(&Person::height, "height")
+		.AddVariable(&Person::isFemale, "isFemale");
+
+	std::mt19937 rng(1);
+	std::vector<Person> people(count);
+	for (auto& person : people)
+	{
+		person.height = float(rng() % 100000) * 1e-5f + 1.0f;
+	}
+
+	epoch::Guard guard;
+	auto& getter = GetType<Person>()->AsClass()->GetVariable()[1];
+	auto boxed = [&](size_t n)
+	{
+		std::vector<uint32_t> index(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			index[i] = uint32_t(i);
+		}
+		std::vector<any> args(1);
+		std::sort(index.begin(), index.end(), [&](uint32_t a, uint32_t b)
+		{
+			args[0] = make_ref(people[a]);
+			any lhs = getter.call(args);
+			args[0] = make_ref(people[b]);
+			any rhs = getter.call(args);
+			return *try_cast<float>(lhs) < *try_cast<float>(rhs);
+		});
+		return index;
+	};
+
+	std::vector<uint32_t> byBoxed, byRadix, byRadixSmall;
+	double boxedTime = Seconds([&] { byBoxed = boxed(boxedCount); });
+	double radixSmall = Seconds([&] { byRadixSmall = BuildIndex(people.data(), boxedCount, GetStaticType<Person>().GetVariable()[1]); });
+	double radixTime = Seconds([&] { byRadix = BuildIndex(people.data(), count, GetStaticType<Person>().GetVariable()[1]); });
+
+	bool same = std::equal(byBoxed.begin(), byBoxed.end(), byRadixSmall.begin(), [&](uint32_t a, uint32_t b) { return people[a].height == people[b].height; });
+	std::printf("sort by a float member, %zu hardware threads\n", size_t(ThreadPool::Instance().Size()));
+	std::printf("  std::sort + getter   : %8.1f ms for %zu\n", boxedTime * 1e3, boxedCount);
+	std::printf("  BuildIndex           : %8.1f ms for %zu, %.1fx (%s order)\n", radixSmall * 1e3, boxedCount, boxedTime / radixSmall, same ? "same" : "DIFFERENT");
+	std::printf("  BuildIndex           : %8.1f ms for %zu\n", radixTime * 1e3, count);
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "tuple_visit.h"
+#include "bench.h"
+
+// Visiting element i of a tuple, i only known at run time: VisitAt's table of
+// function pointers against a linear chain of comparisons, for tuples of 8,
+// 64 and 256 elements, with uniformly random indices.
+
+template<size_t I>
+struct Slot
+{
+	uint32_t value = I * 2654435761u;
+};
+
+template<size_t ...Idx>
+auto make_slots(std::index_sequence<Idx...>) -> std::tuple<Slot<Idx>...>;
+
+template<size_t N>
+using Slots = decltype(make_slots(std::make_index_sequence<N>()));
+
+template<typename Tuple, typename Function, size_t ...Idx>
+uint32_t visit_chain(Tuple& tuple, size_t n, Function& f, std::index_sequence<Idx...>)
+{
+	uint32_t result = 0;
+	((n == Idx ? (result = f(std::get<Idx>(tuple)), true) : false) || ...);
+	return result;
+}
+
+template<size_t N>
+void run(const std::vector<uint32_t>& indices)
+{
+	Slots<N> slots;
+	auto f = [](auto& slot) { return slot.value; };
+
+	uint32_t tableSum = 0;
+	double table = Seconds([&]
+	{
+		for (uint32_t idx : indices)
+		{
+			tableSum += VisitAt(slots, idx % N, f);
+		}
+	});
+
+	uint32_t chainSum = 0;
+	double chain = Seconds([&]
+	{
+		for (uint32_t idx : indices)
+		{
+			chainSum += visit_chain(slots, idx % N, f, std::make_index_sequence<N>());
+		}
+	});
+
+	std::printf("  %3zu elements : table %6.2f ns, if chain %6.2f ns per visit (%s)\n", N,
+		table / indices.size() * 1e9, chain / indices.size() * 1e9, tableSum == chainSum ? "same" : "DIFFERENT");
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 20000000);
+
+	std::vector<uint32_t> indices(count);
+	uint32_t state = 12345;
+	for (auto& idx : indices)
+	{
+		state = state * 1664525u + 1013904223u;
+		idx = state >> 8;
+	}
+
+	std::printf("%zu visits at random indices\n", count);
+	run<8>(indices);
+	run<64>(indices);
+	run<256>(indices);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "bench.h"
+
+// Summing the numeric members of N objects through VisitFields: offsets from
+// a static table, the same class registered at run time only (every member
+// through its address thunk), and the boxed getter walk both replace.
+
+struct Tabled
+{
+	int hp = 1;
+	float speed = 2;
+	double mass = 3;
+	std::string tag = "t";
+	unsigned level = 4;
+	short team = 5;
+};
+
+BEGIN_STATIC_CLASS(Tabled)
+	static_var(hp)
+	static_var(speed)
+	static_var(mass)
+	static_var(tag)
+	static_var(level)
+	static_var(team)
+END_STATIC_CLASS(Tabled)
+
+struct Untabled
+{
+	int hp = 1;
+	float speed = 2;
+	double mass = 3;
+	std::string tag = "t";
+	unsigned level = 4;
+	short team = 5;
+};
+
+template<typename T>
+void regist(const char* name)
+{
+	Registrar<T>().Regist(name)
+		.AddVariable(&T::hp, "hp")
+		.AddVariable(&T::speed, "speed")
+		.AddVariable(&T::mass, "mass")
+		.AddVariable(&T::tag, "tag")
+		.AddVariable(&T::level, "level")
+		.AddVariable(&T::team, "team");
+}
+
+template<typename T>
+double visit_sum(std::vector<T>& objects)
+{
+	double sum = 0;
+	for (auto& obj : objects)
+	{
+		VisitFields(obj, [&](std::string_view, auto& value)
+		{
+			if constexpr (std::is_arithmetic_v<std::remove_reference_t<decltype(value)>>)
+			{
+				sum += value;
+			}
+		});
+	}
+	return sum;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = Arg(argc, argv, 1, 200000);
+
+	regist<Tabled>("Tabled");
+	regist<Untabled>("Untabled");
+
+	std::vector<Tabled> tabled(count);
+	std::vector<Untabled> untabled(count);
+	double sums[3] = {};
+
+	double offsets = Seconds([&] { sums[0] = visit_sum(tabled); });
+	double thunks = Seconds([&] { sums[1] = visit_sum(untabled); });
+
+	double boxed = Seconds([&]
+	{
+		epoch::Guard guard;
+		auto& vars = GetType<Untabled>()->AsClass()->GetVariable();
+		std::vector<any> args(1);
+		for (auto& obj : untabled)
+		{
+			args[0] = make_ref(obj);
+			for (auto& var : vars)
+			{
+				any value = var.call(args);
+				const Type* type = value.typeInfo_;
+				if (type == GetType<int>()) sums[2] += *try_cast<int>(value);
+				else if (type == GetType<unsigned>()) sums[2] += *try_cast<unsigned>(value);
+				else if (type == GetType<short>()) sums[2] += *try_cast<short>(value);
+				else if (type == GetType<float>()) sums[2] += *try_cast<float>(value);
+				else if (type == GetType<double>()) sums[2] += *try_cast<double>(value);
+			}
+		}
+	});
+
+	size_t fields = count * 6;
+	std::printf("%zu objects, 6 members each\n", count);
+	std::printf("  static offsets  : %6.2f ns per member\n", offsets / fields * 1e9);
+	std::printf("  address thunks  : %6.2f ns per member\n", thunks / fields * 1e9);
+	std::printf("  boxed getters   : %6.2f ns per member\n", boxed / fields * 1e9);
+	std::printf("(%g %g %g)\n", sums[0], sums[1], sums[2]);
+	return 0;
+}
@@ -1,8 +1,16 @@
 #include <type_traits>
 #include <tuple>
 #include <string>
+#include <cassert>
+#include <array>
+#include <algorithm>
+#include <new>
 #include "function_traits.h"
 #include "variable_traits.h"
+#include "soa_vector.h"
+#include "member_name.h"
+#include "packed_layout.h"
+#include "tuple_visit.h"
 
 struct Person final
 {
@@ -30,14 +38,10 @@ struct Person final
 template<typename T>
 struct TypeInfo;
 
-template<typename RetT, typename ...Params>
-auto function_pointer_type(RetT(*)(Params...)) -> RetT(*)(Params...);
-
-template<typename RetT, typename Class, typename ...Params>
-auto function_pointer_type(RetT(Class::*)(Params...)) -> RetT(Class::*)(Params...);
-
-template<typename RetT, typename Class, typename ...Params>
-auto function_pointer_type(RetT(Class::*)(Params...) const ) -> RetT(Class::*)(Params...) const;
+// any free or member function pointer function_traits knows about:
+// cv and ref qualified, noexcept and C variadic forms included.
+template<typename F>
+auto function_pointer_type(F) -> typename function_traits<F>::pointer;
 
 template<auto F>
 using function_pointer_type_t = decltype(function_pointer_type(F));
@@ -81,6 +85,11 @@ struct basic_field_traits<T, true> : public function_traits<T>
 	{
 		return false;
 	}
+
+	constexpr size_t param_count() const
+	{
+		return std::tuple_size_v<typename traits::args>;
+	}
 };
 
 template<typename T>
@@ -107,17 +116,12 @@ struct basic_field_traits<T, false> : public variable_traits<T>
 	{
 		return true;
 	}
-
-	constexpr size_t param_count() const
-	{
-		return std::tuple_size_v<typename traits::args>;
-	}
 };
 
 template<typename T>
 struct field_traits : public basic_field_traits<T, is_function_v<T>>
 {
-	constexpr field_traits(T&& pointer, std::string_view name) : pointer{ pointer }, name(name.substr(name.find_last_of(":"))) {}
+	constexpr field_traits(T&& pointer, std::string_view name) : pointer{ pointer }, name(member_name(name)) {}
 
 	T pointer;
 	std::string_view name;
@@ -126,6 +130,8 @@ struct field_traits : public basic_field_traits<T, is_function_v<T>>
 #define BEGIN_CLASS(x) template<> struct TypeInfo<x> {
 #define functions(...)  static constexpr auto functions = std::make_tuple(__VA_ARGS__);
 #define func(F)          field_traits{ F, #F }
+#define variables(...)  static constexpr auto variables = std::make_tuple(__VA_ARGS__);
+#define var(V)           field_traits{ V, #V }
 #define END_CLASS() };
 
 BEGIN_CLASS(Person)
@@ -134,8 +140,23 @@ BEGIN_CLASS(Person)
 		func(&Person::IntroduceMyself),
 		func(&Person::IsFemale)
 	)
+	variables(
+		var(&Person::familyName),
+		var(&Person::height),
+		var(&Person::isFemale)
+	)
 END_CLASS()
 
+// the helper macros have common names, keep them out of everything below.
+#undef BEGIN_CLASS
+#undef functions
+#undef func
+#undef variables
+#undef var
+#undef END_CLASS
+
+static_assert(std::get<0>(TypeInfo<Person>::functions).name == "GetMarried");
+
 template<typename T>
 constexpr auto reflected_type()
 {
@@ -153,12 +174,14 @@ void VisitTuple(const std::tuple<Args...>& tuple, Class* instance)
 	}
 	else
 	{
-		if constexpr (auto elem = std::get<Idx>(tuple); elem.param_count()= 0)
-		{
-			(instance->*elem.pointer)();
+		using elem_type = std::tuple_element_t<Idx, tuple_type>;
 
-			VisitTuple<Idx + 1>(tuple, instance);
+		if constexpr (std::tuple_size_v<typename elem_type::args> == 0)
+		{
+			(instance->*std::get<Idx>(tuple).pointer)();
 		}
+
+		VisitTuple<Idx + 1>(tuple, instance);
 	}
 }
 
@@ -170,6 +193,12 @@ void VisitTuple(Tuple tuple, Function&& f, std::index_sequence<Idx...>)
 	(f(std::get<Idx>(tuple)), ...);
 }
 
+template<typename T>
+struct has_no_param
+{
+	static constexpr bool value = std::tuple_size_v<typename T::args> == 0;
+};
+
 template<typename ...Args>
 struct type_list
 {
@@ -305,6 +334,42 @@ namespace detail {
 		>;
 	};
 
+	// stable sort, F<A, B>::value is true when A must go before B.
+	// insert puts T in front of the first element that does not have to precede it.
+
+	template<typename, typename, template<typename, typename> typename>
+	struct insert;
+
+	template<typename T, template<typename, typename> typename F>
+	struct insert<T, type_list<>, F>
+	{
+		using type = type_list<T>;
+	};
+
+	template<typename T, typename H, typename ...Remains, template<typename, typename> typename F>
+	struct insert<T, type_list<H, Remains...>, F>
+	{
+		using type = std::conditional_t<!F<H, T>::value,
+			type_list<T, H, Remains...>,
+			typename cons<H, typename insert<T, type_list<Remains...>, F>::type>::type
+		>;
+	};
+
+	template<typename, template<typename, typename> typename>
+	struct sort_by;
+
+	template<template<typename, typename> typename F>
+	struct sort_by<type_list<>, F>
+	{
+		using type = type_list<>;
+	};
+
+	template<typename T, typename ...Remains, template<typename, typename> typename F>
+	struct sort_by<type_list<T, Remains...>, F>
+	{
+		using type = typename insert<T, typename sort_by<type_list<Remains...>, F>::type, F>::type;
+	};
+
 }
 
 template<typename TypeList>
@@ -349,6 +414,50 @@ struct is_not_char
 	static constexpr bool value = !std::is_same_v<T, char>;
 };
 
+template<typename TypeList, template<typename, typename> typename F>
+using sort_by = typename detail::sort_by<TypeList, F>::type;
+
+template<typename TypeList, template<typename> typename F>
+using map = typename detail::map<TypeList, F>::type;
+
+// element of a type list that remembers its declaration index.
+
+template<size_t I, typename T>
+struct indexed
+{
+	static constexpr size_t index = I;
+	using type = T;
+};
+
+template<typename T>
+struct unindex
+{
+	using type = typename T::type;
+};
+
+template<typename A, typename B>
+struct align_greater
+{
+	static constexpr bool value = alignof(typename A::type) > alignof(typename B::type);
+};
+
+namespace detail {
+
+	template<typename, typename>
+	struct index_types;
+
+	template<size_t ...Idx, typename ...Args>
+	struct index_types<std::index_sequence<Idx...>, type_list<Args...>>
+	{
+		using type = type_list<indexed<Idx, Args>...>;
+	};
+}
+
+// storage order of packed_tuple<Args...> spelled with the type_list metaprograms,
+// it must agree with packed_offsets.
+template<typename ...Args>
+using packed_storage_types = map<sort_by<typename detail::index_types<std::index_sequence_for<Args...>, type_list<Args...>>::type, align_greater>, unindex>;
+
 //template<typename, size_t N>
 //struct get_interger_type_count;
 //
@@ -370,6 +479,7 @@ int main0()
 {
 	using nameType = variable_traits<decltype(&Person::familyName)>;
 	using functionType = variable_traits<decltype(&Person::GetMarried)>;
+	static_assert(std::is_same_v<nameType::class_type, Person> && std::is_same_v<functionType::class_type, Person>);
 
 	using type1 = function_pointer_type_t<&Person::GetMarried>;
 	using type2 = function_pointer_type_t<&Person::IntroduceMyself>;
@@ -379,13 +489,35 @@ int main0()
 	static_assert(std::is_same_v<type2, void(Person::*)(void)const>);
 	static_assert(std::is_same_v<type3, bool(Person::*)(void)const>);
 
+	struct Signatures
+	{
+		void ByConstRef(const std::string&) const noexcept {}
+		void ByMove(std::string&&) && {}
+		int Printf(const char*, ...) volatile { return 0; }
+	};
+
+	using traits1 = function_traits_t<&Signatures::ByConstRef>;
+	using traits2 = function_traits_t<&Signatures::ByMove>;
+	using traits3 = function_traits_t<&Signatures::Printf>;
+
+	static_assert(traits1::is_const && traits1::is_noexcept);
+	static_assert(traits2::ref == ref_qualifier::RValue && !traits2::is_const);
+	static_assert(traits3::is_volatile && traits3::is_variadic);
+	static_assert(param_traits<traits1::arg<0>>::category == value_category::ConstLValueRef);
+	static_assert(param_traits<traits2::arg<0>>::can_move);
+
 
 	auto info = reflected_type<Person>();
 
-	VisitTuple(t, [](auto&& elem) {
+	VisitTuple(t, [](auto&&) {
 		
 	}, std::make_index_sequence<std::tuple_size_v<decltype(t)>>());
 
+	Person person;
+	VisitTuple<0>(info.functions, &person);
+	VisitAt(info.functions, 1, [](auto&& elem) { return elem.name; });
+	VisitIf<has_no_param>(info.functions, [&](auto&& elem) { (person.*elem.pointer)(); });
+
 
 	using type = type_list<int, char, double, int, char, float>;
 	using first_elem = head<type>;
@@ -396,5 +528,29 @@ int main0()
 	using List = typename detail::map<type, change_to_float>::type;
 	using initresult = init<type>;
 	using filterresult = filter<type, is_not_char>;
+	static_assert(std::is_same_v<first_elem, int> && std::is_same_v<tail_elem, type_list<char, double, int, char, float>>);
+	static_assert(std::is_same_v<result, double> && value == 4);
+	static_assert(std::is_same_v<List, type_list<float, float, double, float, float, float>>);
+	static_assert(std::is_same_v<initresult, type_list<int, char, double, int, char>>);
+	static_assert(std::is_same_v<filterresult, type_list<int, double, int, float>>);
+
+	using args = packed_tuple<char, double, int, char, short>;
+	static_assert(sizeof(args) == 16 && sizeof(std::tuple<char, double, int, char, short>) == 24);
+	static_assert(args::offset<1> == 0 && args::offset<0> == 14);
+	static_assert(std::is_same_v<packed_storage_types<char, double, int, char, short>, type_list<double, int, short, char, char>>);
+	args packedArgs{ 'a', 1.0, 2, 'b', 3 };
+	if (get<1>(packedArgs) != 1.0 || get<4>(packedArgs) != 3)
+	{
+		return 1;
+	}
+
+	soa_vector<Person> people;
+	people.push_back(Person{ "Li", 1.8f, false });
+	float totalHeight = 0;
+	for (float height : people.column<&Person::height>())
+	{
+		totalHeight += height;
+	}
+	people[0].get<&Person::isFemale>() = true;
 	return 0;
 }
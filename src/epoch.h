@@ -0,0 +1,186 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace epoch {
+
+	// Epoch based reclamation.
+	// Readers announce the global epoch in a thread local record while they hold
+	// pointers into shared data. Writers unlink the old object, retire it with the
+	// current epoch, and free it once no reader announced an epoch older than that.
+
+	class Domain final
+	{
+	public:
+		static constexpr uint64_t Idle = std::numeric_limits<uint64_t>::max();
+
+		struct Record
+		{
+			std::atomic<uint64_t> local{ Idle };
+			std::atomic<bool> used{ false };
+			Record* next = nullptr;
+			uint32_t depth = 0;
+		};
+
+		static Domain& Instance()
+		{
+			static Domain inst;
+			return inst;
+		}
+
+		void Enter()
+		{
+			Record& record = Local();
+			if (record.depth++ == 0)
+			{
+				record.local.store(global_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+		}
+
+		void Leave()
+		{
+			Record& record = Local();
+			if (--record.depth == 0)
+			{
+				record.local.store(Idle, std::memory_order_release);
+			}
+		}
+
+		template<typename T>
+		void Retire(T* ptr)
+		{
+			Retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+		}
+
+		void Retire(void* ptr, void(*deleter)(void*))
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			retired_.push_back(Retired{ ptr, deleter, global_.fetch_add(1, std::memory_order_seq_cst) });
+			reclaim();
+		}
+
+		void Reclaim()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			reclaim();
+		}
+
+		size_t Pending()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return retired_.size();
+		}
+
+	private:
+
+		struct Retired
+		{
+			void* ptr;
+			void(*deleter)(void*);
+			uint64_t epoch;
+		};
+
+		struct Slot
+		{
+			Record* record = nullptr;
+
+			~Slot()
+			{
+				if (record)
+				{
+					record->local.store(Idle, std::memory_order_release);
+					record->used.store(false, std::memory_order_release);
+				}
+			}
+		};
+
+		std::atomic<uint64_t> global_{ 0 };
+		std::atomic<Record*> records_{ nullptr };
+		std::mutex mutex_;
+		std::vector<Retired> retired_;
+
+		Domain() = default;
+
+		// runs at exit, after every reader thread is gone.
+		~Domain()
+		{
+			for (auto& item : retired_)
+			{
+				item.deleter(item.ptr);
+			}
+			for (Record* it = records_.load(std::memory_order_relaxed); it;)
+			{
+				Record* next = it->next;
+				delete it;
+				it = next;
+			}
+		}
+
+		Record& Local()
+		{
+			thread_local Slot slot;
+			if (!slot.record)
+			{
+				slot.record = acquire();
+			}
+			return *slot.record;
+		}
+
+		Record* acquire()
+		{
+			for (Record* it = records_.load(std::memory_order_acquire); it; it = it->next)
+			{
+				bool expected = false;
+				if (it->used.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+				{
+					return it;
+				}
+			}
+
+			// records live as long as the domain, so the list can be walked without locking.
+			Record* record = new Record;
+			record->used.store(true, std::memory_order_relaxed);
+			record->next = records_.load(std::memory_order_relaxed);
+			while (!records_.compare_exchange_weak(record->next, record, std::memory_order_acq_rel)) {}
+			return record;
+		}
+
+		void reclaim()
+		{
+			uint64_t oldest = Idle;
+			for (Record* it = records_.load(std::memory_order_acquire); it; it = it->next)
+			{
+				uint64_t local = it->local.load(std::memory_order_seq_cst);
+				oldest = local < oldest ? local : oldest;
+			}
+
+			size_t keep = 0;
+			for (auto& item : retired_)
+			{
+				if (item.epoch < oldest)
+				{
+					item.deleter(item.ptr);
+				}
+				else
+				{
+					retired_[keep++] = item;
+				}
+			}
+			retired_.resize(keep);
+		}
+	};
+
+	class Guard final
+	{
+	public:
+		Guard() { Domain::Instance().Enter(); }
+		~Guard() { Domain::Instance().Leave(); }
+
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+	};
+}
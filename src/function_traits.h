@@ -1,9 +1,17 @@
 #pragma once
 #include <type_traits>
 #include <tuple>
+#include <cstddef>
 
 namespace datail {
 
+	enum class ref_qualifier
+	{
+		None,
+		LValue,
+		RValue,
+	};
+
 	template<typename>
 	struct basic_function_traits;
 
@@ -12,38 +20,123 @@ namespace datail {
 	{
 		using args = std::tuple<Args...>;
 		using return_type = Ret;
+		static constexpr size_t arity = sizeof...(Args);
+
+		template<size_t I>
+		using arg = std::tuple_element_t<I, args>;
 	};
 }
 
+using ref_qualifier = datail::ref_qualifier;
+
 template<typename>
 struct function_traits;
 
-template<typename Ret, typename ...Args>
-struct function_traits<Ret(Args...)> : datail::basic_function_traits<Ret(Args...)>
+// free functions, Ret(Args...) [noexcept] and the C variadic Ret(Args..., ...) [noexcept].
+
+template<typename Ret, bool NoExcept, typename ...Args>
+struct function_traits<Ret(Args...) noexcept(NoExcept)> : datail::basic_function_traits<Ret(Args...)>
 {
-	using type = Ret(Args...);
+	using type = Ret(Args...) noexcept(NoExcept);
 	using args_with_class = std::tuple<Args...>;
-	using pointer = Ret(*)(Args...);
+	using pointer = Ret(*)(Args...) noexcept(NoExcept);
 	static constexpr bool is_member = false;
 	static constexpr bool is_const = false;
+	static constexpr bool is_volatile = false;
+	static constexpr bool is_noexcept = NoExcept;
+	static constexpr bool is_variadic = false;
+	static constexpr ref_qualifier ref = ref_qualifier::None;
 };
 
-template<typename Ret, typename Class, typename ...Args>
-struct function_traits<Ret(Class::*)(Args...)> : datail::basic_function_traits<Ret(Args...)>
+template<typename Ret, bool NoExcept, typename ...Args>
+struct function_traits<Ret(Args..., ...) noexcept(NoExcept)> : datail::basic_function_traits<Ret(Args...)>
 {
-	using type = Ret(Class::*)(Args...);
-	using args_with_class = std::tuple<Class*, Args...>;
-	using pointer = Ret(Class::*)(Args...);
-	static constexpr bool is_member = true;
+	using type = Ret(Args..., ...) noexcept(NoExcept);
+	using args_with_class = std::tuple<Args...>;
+	using pointer = Ret(*)(Args..., ...) noexcept(NoExcept);
+	static constexpr bool is_member = false;
 	static constexpr bool is_const = false;
+	static constexpr bool is_volatile = false;
+	static constexpr bool is_noexcept = NoExcept;
+	static constexpr bool is_variadic = true;
+	static constexpr ref_qualifier ref = ref_qualifier::None;
 };
 
-template<typename Ret, typename Class, typename ...Args>
-struct function_traits<Ret(Class::*)(Args...) const> : datail::basic_function_traits<Ret(Args...)>
+template<typename Ret, bool NoExcept, typename ...Args>
+struct function_traits<Ret(*)(Args...) noexcept(NoExcept)> : function_traits<Ret(Args...) noexcept(NoExcept)> {};
+
+template<typename Ret, bool NoExcept, typename ...Args>
+struct function_traits<Ret(*)(Args..., ...) noexcept(NoExcept)> : function_traits<Ret(Args..., ...) noexcept(NoExcept)> {};
+
+// member functions, every cv / ref / noexcept / variadic combination.
+
+#define MEMBER_FUNCTION_TRAITS(PARAMS, IS_VARIADIC, CV, IS_CONST, IS_VOLATILE, REF, REF_KIND)                            \
+template<typename Ret, typename Class, bool NoExcept, typename ...Args>                                                   \
+struct function_traits<Ret(Class::*)(PARAMS()) CV REF noexcept(NoExcept)> : datail::basic_function_traits<Ret(Args...)>   \
+{                                                                                                                         \
+	using type = Ret(Class::*)(PARAMS()) CV REF noexcept(NoExcept);                                                       \
+	using class_type = Class;                                                                                             \
+	using args_with_class = std::tuple<Class*, Args...>;                                                                  \
+	using pointer = type;                                                                                                 \
+	static constexpr bool is_member = true;                                                                               \
+	static constexpr bool is_const = IS_CONST;                                                                            \
+	static constexpr bool is_volatile = IS_VOLATILE;                                                                      \
+	static constexpr bool is_noexcept = NoExcept;                                                                         \
+	static constexpr bool is_variadic = IS_VARIADIC;                                                                      \
+	static constexpr ref_qualifier ref = ref_qualifier::REF_KIND;                                                         \
+};
+
+#define MEMBER_FUNCTION_TRAITS_REF(PARAMS, IS_VARIADIC, CV, IS_CONST, IS_VOLATILE)     \
+	MEMBER_FUNCTION_TRAITS(PARAMS, IS_VARIADIC, CV, IS_CONST, IS_VOLATILE, , None)   \
+	MEMBER_FUNCTION_TRAITS(PARAMS, IS_VARIADIC, CV, IS_CONST, IS_VOLATILE, &, LValue) \
+	MEMBER_FUNCTION_TRAITS(PARAMS, IS_VARIADIC, CV, IS_CONST, IS_VOLATILE, &&, RValue)
+
+#define MEMBER_FUNCTION_TRAITS_CV(PARAMS, IS_VARIADIC)                                   \
+	MEMBER_FUNCTION_TRAITS_REF(PARAMS, IS_VARIADIC, , false, false)                     \
+	MEMBER_FUNCTION_TRAITS_REF(PARAMS, IS_VARIADIC, const, true, false)                 \
+	MEMBER_FUNCTION_TRAITS_REF(PARAMS, IS_VARIADIC, volatile, false, true)              \
+	MEMBER_FUNCTION_TRAITS_REF(PARAMS, IS_VARIADIC, const volatile, true, true)
+
+#define MEMBER_FUNCTION_PARAMS() Args...
+#define MEMBER_FUNCTION_PARAMS_VARIADIC() Args..., ...
+
+MEMBER_FUNCTION_TRAITS_CV(MEMBER_FUNCTION_PARAMS, false)
+MEMBER_FUNCTION_TRAITS_CV(MEMBER_FUNCTION_PARAMS_VARIADIC, true)
+
+#undef MEMBER_FUNCTION_PARAMS_VARIADIC
+#undef MEMBER_FUNCTION_PARAMS
+#undef MEMBER_FUNCTION_TRAITS_CV
+#undef MEMBER_FUNCTION_TRAITS_REF
+#undef MEMBER_FUNCTION_TRAITS
+
+// how a parameter is passed, so the invoker can bind by reference or move
+// instead of copying.
+
+enum class value_category
 {
-	using type = Ret(Class::*)(Args...) const;
-	using args_with_class = std::tuple<Class*, Args...>;
-	using pointer = Ret(Class::*)(Args...) const;
-	static constexpr bool is_member = true;
-	static constexpr bool is_const = true;
-};
\ No newline at end of file
+	Value,
+	LValueRef,
+	ConstLValueRef,
+	RValueRef,
+};
+
+template<typename T>
+struct param_traits
+{
+	using value_type = std::remove_cv_t<std::remove_reference_t<T>>;
+
+	static constexpr value_category category =
+		std::is_rvalue_reference_v<T> ? value_category::RValueRef :
+		!std::is_lvalue_reference_v<T> ? value_category::Value :
+		std::is_const_v<std::remove_reference_t<T>> ? value_category::ConstLValueRef :
+		value_category::LValueRef;
+
+	// binds directly to the caller's object, never copies.
+	static constexpr bool by_reference = std::is_reference_v<T>;
+
+	// the callee may take ownership, the source can be moved from.
+	static constexpr bool can_move = category == value_category::RValueRef || category == value_category::Value;
+
+	// the callee may write through it.
+	static constexpr bool is_mutable = category == value_category::LValueRef || category == value_category::RValueRef;
+};
@@ -0,0 +1,197 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Type;
+
+template<typename T>
+const Type* GetType();
+
+// 32 bit handle: low bits index a slot, high bits hold the slot generation.
+// A handle goes stale as soon as its object is destroyed, and a later object
+// reusing the slot gets another generation. Live generations are odd, so a
+// free slot never matches a handle, and zero is never a valid handle.
+
+struct Handle
+{
+	static constexpr uint32_t IndexBits = 20;
+	static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+	static constexpr uint32_t GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+	uint32_t value = 0;
+
+	uint32_t index() const { return value & IndexMask; }
+	uint32_t generation() const { return value >> IndexBits; }
+	explicit operator bool() const { return value != 0; }
+
+	bool operator==(Handle o) const { return value == o.value; }
+	bool operator!=(Handle o) const { return value != o.value; }
+
+	static Handle Make(uint32_t index, uint32_t generation)
+	{
+		return Handle{ (generation << IndexBits) | index };
+	}
+};
+
+// type erased view, so tools can walk every live object of a reflected type.
+class BasicHandlePool
+{
+public:
+	virtual ~BasicHandlePool() = default;
+
+	virtual const Type* GetType() const = 0;
+	virtual void* Resolve(Handle handle) = 0;
+	virtual void* Data() = 0;
+	virtual size_t Size() const = 0;
+	virtual size_t Stride() const = 0;
+	virtual Handle HandleAt(size_t dense) const = 0;
+
+	static std::vector<BasicHandlePool*>& Pools()
+	{
+		static std::vector<BasicHandlePool*> pools;
+		return pools;
+	}
+
+	static BasicHandlePool* Find(const Type* type)
+	{
+		for (auto pool : Pools())
+		{
+			if (pool->GetType() == type)
+			{
+				return pool;
+			}
+		}
+		return nullptr;
+	}
+};
+
+// Objects live in one dense array, destroy swaps the last one into the hole.
+// Slots map a handle index to the dense position in O(1), no hashing. A slot
+// whose generation would wrap is retired instead of reused, so a stale handle
+// can never resolve to a later object. Retired slots are never given back:
+// each one lowers the pool's capacity of IndexMask + 1 objects for good.
+template<typename T>
+class HandlePool final : public BasicHandlePool
+{
+public:
+	static HandlePool& Instance()
+	{
+		static HandlePool inst;
+		return inst;
+	}
+
+	// Handle{} when every index is in use, nothing is constructed then.
+	template<typename ...Args>
+	Handle Create(Args&&... args)
+	{
+		uint32_t index;
+		if (freeHead_ != Invalid)
+		{
+			index = freeHead_;
+			freeHead_ = slots_[index].dense;
+		}
+		else
+		{
+			if (slots_.size() > Handle::IndexMask)
+			{
+				return Handle{};
+			}
+			index = static_cast<uint32_t>(slots_.size());
+			slots_.push_back(Slot{ Invalid, 0 });
+		}
+
+		Slot& slot = slots_[index];
+		slot.generation++;
+		slot.dense = static_cast<uint32_t>(dense_.size());
+		dense_.emplace_back(std::forward<Args>(args)...);
+		handles_.push_back(Handle::Make(index, slot.generation));
+		return handles_.back();
+	}
+
+	bool Destroy(Handle handle)
+	{
+		if (!Get(handle))
+		{
+			return false;
+		}
+
+		Slot& slot = slots_[handle.index()];
+		uint32_t dense = slot.dense;
+		uint32_t last = static_cast<uint32_t>(dense_.size() - 1);
+
+		if (dense != last)
+		{
+			dense_[dense] = std::move(dense_[last]);
+			handles_[dense] = handles_[last];
+			slots_[handles_[dense].index()].dense = dense;
+		}
+		dense_.pop_back();
+		handles_.pop_back();
+
+		slot.dense = Invalid;
+		if (slot.generation == Handle::GenerationMask)
+		{
+			slot.generation = 0;
+			retired_++;
+			return true;
+		}
+
+		slot.generation++;
+		slot.dense = freeHead_;
+		freeHead_ = handle.index();
+		return true;
+	}
+
+	T* Get(Handle handle)
+	{
+		uint32_t index = handle.index();
+		if (index >= slots_.size())
+		{
+			return nullptr;
+		}
+
+		const Slot& slot = slots_[index];
+		if (slot.generation != handle.generation() || !is_live(slot) || slot.dense >= dense_.size())
+		{
+			return nullptr;
+		}
+		return &dense_[slot.dense];
+	}
+
+	// slots given up after their generation ran out.
+	size_t Retired() const { return retired_; }
+
+	T* begin() { return dense_.data(); }
+	T* end() { return dense_.data() + dense_.size(); }
+
+	virtual const Type* GetType() const override { return ::GetType<T>(); }
+	virtual void* Resolve(Handle handle) override { return Get(handle); }
+	virtual void* Data() override { return dense_.data(); }
+	virtual size_t Size() const override { return dense_.size(); }
+	virtual size_t Stride() const override { return sizeof(T); }
+	virtual Handle HandleAt(size_t dense) const override { return handles_[dense]; }
+
+private:
+	static constexpr uint32_t Invalid = ~0u;
+
+	struct Slot
+	{
+		uint32_t dense;
+		uint32_t generation;
+	};
+
+	std::vector<T> dense_;
+	std::vector<Handle> handles_;
+	std::vector<Slot> slots_;
+	uint32_t freeHead_ = Invalid;
+	size_t retired_ = 0;
+
+	static bool is_live(const Slot& slot) { return (slot.generation & 1) != 0; }
+
+	HandlePool()
+	{
+		Pools().push_back(this);
+	}
+};
@@ -0,0 +1,189 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "static_reflect.h"
+
+// Memory layout analysis over the static reflection tables.
+// Members that are not registered show up as holes as well.
+
+namespace layout {
+
+	struct Field
+	{
+		std::string_view name;
+		size_t offset;
+		size_t size;
+		size_t align;
+	};
+
+	struct Hole
+	{
+		size_t offset;
+		size_t size;
+	};
+
+	struct Report
+	{
+		std::string_view name;
+		size_t size = 0;
+		size_t align = 0;
+		std::vector<Field> fields;
+		std::vector<Hole> holes;
+		size_t padding = 0;
+		size_t tailPadding = 0;
+		std::vector<std::string_view> suggestedOrder;
+		size_t suggestedSize = 0;
+	};
+
+	struct Split
+	{
+		std::vector<std::string_view> hot;
+		std::vector<std::string_view> cold;
+		size_t hotSize = 0;
+		size_t coldSize = 0;
+	};
+
+	namespace detail {
+
+		inline size_t align_up(size_t value, size_t align)
+		{
+			return (value + align - 1) / align * align;
+		}
+
+		// size of a struct holding fields in the given order.
+		inline size_t packed_size(const std::vector<Field>& fields)
+		{
+			size_t offset = 0;
+			size_t align = 1;
+			for (auto& field : fields)
+			{
+				offset = align_up(offset, field.align) + field.size;
+				align = std::max(align, field.align);
+			}
+			return align_up(offset, align);
+		}
+
+		// biggest alignment first, then biggest size, keeps declaration order on ties.
+		inline void sort_by_align(std::vector<Field>& fields)
+		{
+			std::stable_sort(fields.begin(), fields.end(), [](const Field& a, const Field& b)
+			{
+				return a.align != b.align ? a.align > b.align : a.size > b.size;
+			});
+		}
+	}
+
+	inline Report Analyze(const static_reflect::Class& info)
+	{
+		Report report;
+		report.name = info.name;
+		report.size = info.size;
+		report.align = info.align;
+
+		for (auto& var : info.GetVariable())
+		{
+			report.fields.push_back(Field{ var.name, var.offset, var.size, var.align });
+		}
+
+		std::vector<Field> byOffset = report.fields;
+		std::stable_sort(byOffset.begin(), byOffset.end(), [](const Field& a, const Field& b) { return a.offset < b.offset; });
+
+		size_t cursor = 0;
+		for (auto& field : byOffset)
+		{
+			if (field.offset > cursor)
+			{
+				report.holes.push_back(Hole{ cursor, field.offset - cursor });
+				report.padding += field.offset - cursor;
+			}
+			cursor = std::max(cursor, field.offset + field.size);
+		}
+
+		if (report.size > cursor)
+		{
+			report.tailPadding = report.size - cursor;
+			report.holes.push_back(Hole{ cursor, report.tailPadding });
+			report.padding += report.tailPadding;
+		}
+
+		std::vector<Field> sorted = report.fields;
+		detail::sort_by_align(sorted);
+		for (auto& field : sorted)
+		{
+			report.suggestedOrder.push_back(field.name);
+		}
+		report.suggestedSize = detail::packed_size(sorted);
+
+		return report;
+	}
+
+	// accessCounts is indexed like info.GetVariable(). The most accessed members
+	// go to the hot part for as long as it still fits in one cache line.
+	inline Split SuggestHotCold(const static_reflect::Class& info, const uint64_t* accessCounts, size_t cacheLine = 64)
+	{
+		std::vector<size_t> order(info.GetVariable().size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return accessCounts[a] > accessCounts[b]; });
+
+		std::vector<Field> hot;
+		std::vector<Field> cold;
+		for (size_t idx : order)
+		{
+			auto& var = info.GetVariable()[idx];
+			Field field{ var.name, var.offset, var.size, var.align };
+
+			if (accessCounts[idx] != 0)
+			{
+				hot.push_back(field);
+				detail::sort_by_align(hot);
+				if (detail::packed_size(hot) <= cacheLine)
+				{
+					continue;
+				}
+				hot.erase(std::find_if(hot.begin(), hot.end(), [&](const Field& f) { return f.name == field.name; }));
+			}
+			cold.push_back(field);
+		}
+
+		detail::sort_by_align(cold);
+
+		Split split;
+		for (auto& field : hot)
+		{
+			split.hot.push_back(field.name);
+		}
+		for (auto& field : cold)
+		{
+			split.cold.push_back(field.name);
+		}
+		split.hotSize = detail::packed_size(hot);
+		split.coldSize = detail::packed_size(cold);
+		return split;
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Report& report)
+	{
+		os << report.name << ": size " << report.size << ", align " << report.align << ", padding " << report.padding << "\n";
+		for (auto& field : report.fields)
+		{
+			os << "  " << field.name << " @" << field.offset << " size " << field.size << " align " << field.align << "\n";
+		}
+		for (auto& hole : report.holes)
+		{
+			os << "  hole @" << hole.offset << " size " << hole.size << (hole.offset + hole.size == report.size ? " (tail)" : "") << "\n";
+		}
+		os << "  suggested:";
+		for (auto& name : report.suggestedOrder)
+		{
+			os << " " << name;
+		}
+		os << " -> size " << report.suggestedSize << "\n";
+		return os;
+	}
+}
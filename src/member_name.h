@@ -0,0 +1,27 @@
+#pragma once
+#include <string_view>
+
+// Member names taken from the macro token at compile time.
+// "&Person::GetMarried" and "Person::height" both give the bare identifier, the
+// result views the string literal itself, so it lives in read only data.
+
+constexpr std::string_view member_name(std::string_view token)
+{
+	size_t pos = token.find_last_of(':');
+	if (pos != std::string_view::npos)
+	{
+		return token.substr(pos + 1);
+	}
+	return token.substr(token.find_first_not_of('&') == std::string_view::npos ? token.size() : token.find_first_not_of('&'));
+}
+
+// A name whose characters live in read only data for the whole program, so
+// registration keeps the view instead of copying it. member_name_of makes one;
+// wrapping anything but a literal by hand is a promise the caller must keep.
+struct static_name
+{
+	std::string_view value;
+};
+
+// forces constant evaluation, no string work is left for run time.
+#define member_name_of(ptr) ([]() { constexpr static_name name{ member_name(#ptr) }; return name; }())
@@ -0,0 +1,187 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class Type;
+
+template<typename T>
+const Type* GetType();
+
+// Memory accounting of the reflection system, compiled in with REFLECT_MEMORY_STATS.
+// Live heap boxed any payloads are counted per storage mode and per type, the
+// bytes are the size of the box, not what the value owns itself. Metadata is
+// the footprint of the registered Class or Enum. Counters are split in cache
+// line sized shards picked per thread, so payload churn on many threads does
+// not bounce one line; Capture sums the shards.
+
+namespace memstats {
+
+	constexpr size_t Shards = 16;
+	constexpr size_t ModeCount = 8;
+
+	struct Usage
+	{
+		int64_t count = 0;
+		int64_t bytes = 0;
+	};
+
+	class Counter
+	{
+	public:
+		void Add(int64_t count, int64_t bytes)
+		{
+			Shard& shard = shards_[ShardIndex()];
+			shard.count.fetch_add(count, std::memory_order_relaxed);
+			shard.bytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		Usage Read() const
+		{
+			Usage usage;
+			for (auto& shard : shards_)
+			{
+				usage.count += shard.count.load(std::memory_order_relaxed);
+				usage.bytes += shard.bytes.load(std::memory_order_relaxed);
+			}
+			return usage;
+		}
+
+		static size_t ShardIndex()
+		{
+			static std::atomic<size_t> next{ 0 };
+			static thread_local size_t idx = next.fetch_add(1, std::memory_order_relaxed) % Shards;
+			return idx;
+		}
+
+	private:
+		struct alignas(64) Shard
+		{
+			std::atomic<int64_t> count{ 0 };
+			std::atomic<int64_t> bytes{ 0 };
+		};
+
+		Shard shards_[Shards];
+	};
+
+	// one per reflected type, the Type is resolved lazily so a record can be
+	// created before T's factory is.
+	struct TypeRecord
+	{
+		const Type* (*type)();
+		Counter payloads;
+		std::atomic<int64_t> metadata{ 0 };
+	};
+
+	struct TypeUsage
+	{
+		const Type* type;
+		Usage payloads;
+		int64_t metadata;
+	};
+
+	struct Snapshot
+	{
+		std::array<Usage, ModeCount> modes;
+		std::vector<TypeUsage> types;
+
+		Usage Total() const
+		{
+			Usage total;
+			for (auto& mode : modes)
+			{
+				total.count += mode.count;
+				total.bytes += mode.bytes;
+			}
+			return total;
+		}
+	};
+
+	class Registry final
+	{
+	public:
+		static Registry& Instance()
+		{
+			static Registry inst;
+			return inst;
+		}
+
+		Counter& Mode(size_t mode) { return modes_[mode]; }
+
+		template<typename T>
+		TypeRecord& Record()
+		{
+			static TypeRecord& record = add(&GetType<T>);
+			return record;
+		}
+
+		Snapshot Capture()
+		{
+			Snapshot snapshot;
+			for (size_t i = 0; i < ModeCount; i++)
+			{
+				snapshot.modes[i] = modes_[i].Read();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto& record : records_)
+			{
+				snapshot.types.push_back(TypeUsage{ record->type(), record->payloads.Read(), record->metadata.load(std::memory_order_relaxed) });
+			}
+			return snapshot;
+		}
+
+	private:
+		Counter modes_[ModeCount];
+		std::vector<TypeRecord*> records_;
+		std::mutex mutex_;
+
+		// records are never freed, the references handed out stay valid.
+		TypeRecord& add(const Type* (*type)())
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			records_.push_back(new TypeRecord{ type, {}, {} });
+			return *records_.back();
+		}
+	};
+
+#ifdef REFLECT_MEMORY_STATS
+
+	// count live payloads of T created (count > 0) or released (count < 0) in mode.
+	template<typename T>
+	void TrackPayload(size_t mode, int64_t count, size_t size = sizeof(T))
+	{
+		int64_t bytes = count * static_cast<int64_t>(size);
+		Registry::Instance().Mode(mode).Add(count, bytes);
+		Registry::Instance().Record<T>().payloads.Add(count, bytes);
+	}
+
+	template<typename T>
+	void TrackMetadata(size_t bytes)
+	{
+		Registry::Instance().Record<T>().metadata.store(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+	}
+
+	inline Snapshot Capture()
+	{
+		return Registry::Instance().Capture();
+	}
+
+#else
+
+	template<typename T>
+	void TrackPayload(size_t, int64_t, size_t = sizeof(T)) {}
+
+	template<typename T>
+	void TrackMetadata(size_t) {}
+
+	inline Snapshot Capture()
+	{
+		return Snapshot{};
+	}
+
+#endif
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock free multi producer multi consumer queue.
+// Every cell carries a sequence number telling whether it is ready to be
+// written (seq == pos) or read (seq == pos + 1), so producers and consumers
+// only contend on their own position counter.
+
+template<typename T>
+class mpmc_queue
+{
+public:
+	explicit mpmc_queue(size_t capacity)
+		: mask_(round_up(capacity) - 1)
+		, cells_(new Cell[mask_ + 1])
+	{
+		for (size_t i = 0; i <= mask_; i++)
+		{
+			cells_[i].seq.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	mpmc_queue(const mpmc_queue&) = delete;
+	mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+	bool try_push(T value)
+	{
+		size_t pos = tail_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = cells_[pos & mask_];
+			size_t seq = cell.seq.load(std::memory_order_acquire);
+			intptr_t diff = intptr_t(seq) - intptr_t(pos);
+
+			if (diff == 0)
+			{
+				if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.value = std::move(value);
+					cell.seq.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = tail_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool try_pop(T& value)
+	{
+		size_t pos = head_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = cells_[pos & mask_];
+			size_t seq = cell.seq.load(std::memory_order_acquire);
+			intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+
+			if (diff == 0)
+			{
+				if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					value = std::move(cell.value);
+					cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = head_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	size_t capacity() const { return mask_ + 1; }
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> seq;
+		T value;
+	};
+
+	static size_t round_up(size_t value)
+	{
+		size_t result = 2;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	const size_t mask_;
+	std::unique_ptr<Cell[]> cells_;
+	alignas(64) std::atomic<size_t> head_{ 0 };
+	alignas(64) std::atomic<size_t> tail_{ 0 };
+};
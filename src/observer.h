@@ -0,0 +1,345 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Type;
+
+// Property change notification.
+// Reflective setters report (object, class, member) here. Changes are only
+// recorded for classes someone listens to: a per type counter, read with one
+// relaxed load, says so. Each thread records into its own buffer, where
+// repeated writes to the same member of the same object collapse into one
+// entry. Flush, once per frame, merges the buffers, coalescing again across
+// threads, and calls each subscriber from flat arrays.
+
+namespace observe {
+
+	using callback = void(*)(void* user, void* object, const Type* type, uint32_t member);
+
+	// subscribe to AllMembers to hear about every member of a class.
+	constexpr uint32_t AllMembers = ~0u;
+
+	// Type::GetId(), defined next to Type.
+	inline uint32_t TypeId(const Type* type);
+
+	struct Subscriber
+	{
+		callback func;
+		void* user;
+		uint32_t id;
+	};
+
+	class Hub final
+	{
+	public:
+		// type ids beyond this are never watched.
+		static constexpr size_t ChunkBits = 10;
+		static constexpr size_t ChunkSize = size_t(1) << ChunkBits;
+		static constexpr size_t MaxChunks = 64;
+
+		static Hub& Instance()
+		{
+			static Hub inst;
+			return inst;
+		}
+
+		// 0, and nothing subscribed, if the type id is beyond MaxChunks * ChunkSize.
+		uint32_t Subscribe(const Type* type, uint32_t member, callback func, void* user = nullptr)
+		{
+			uint32_t typeId = TypeId(type);
+			if (typeId >= MaxChunks * ChunkSize)
+			{
+				return 0;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (classes_.size() <= typeId)
+			{
+				classes_.resize(typeId + 1);
+			}
+			ClassEntry& entry = classes_[typeId];
+			if (member == AllMembers)
+			{
+				entry.all.push_back(Subscriber{ func, user, nextId_ });
+			}
+			else
+			{
+				if (entry.members.size() <= member)
+				{
+					entry.members.resize(member + 1);
+				}
+				entry.members[member].push_back(Subscriber{ func, user, nextId_ });
+			}
+			watch(typeId).fetch_add(1, std::memory_order_relaxed);
+			return nextId_++;
+		}
+
+		// takes effect from the next Flush, one already delivering may still call it.
+		bool Unsubscribe(uint32_t id)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (uint32_t typeId = 0; typeId < classes_.size(); typeId++)
+			{
+				ClassEntry& entry = classes_[typeId];
+				bool erased = erase(entry.all, id);
+				for (size_t i = 0; !erased && i < entry.members.size(); i++)
+				{
+					erased = erase(entry.members[i], id);
+				}
+				if (erased)
+				{
+					watch(typeId).fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// the setter side. One relaxed load when nobody listens to the class,
+		// otherwise an uncontended lock of this thread's own buffer.
+		void Notify(void* object, const Type* type, uint32_t member)
+		{
+			uint32_t typeId = TypeId(type);
+			const std::atomic<uint32_t>* chunk = typeId < MaxChunks * ChunkSize ? chunks_[typeId >> ChunkBits].load(std::memory_order_acquire) : nullptr;
+			if (!chunk || chunk[typeId & (ChunkSize - 1)].load(std::memory_order_relaxed) == 0)
+			{
+				return;
+			}
+
+			Buffer& buffer = local();
+			std::lock_guard<std::mutex> lock(buffer.mutex);
+			buffer.changes.Record(Change{ object, type, member });
+		}
+
+		// deliver every change recorded since the last flush, once each. Subscribers
+		// are collected under the lock and called after it, so a subscriber may
+		// subscribe, and its writes to reflected members queue for the next flush.
+		void Flush()
+		{
+			std::lock_guard<std::mutex> flushing(flushMutex_);
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (auto& buffer : buffers_)
+				{
+					std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+					for (auto& change : buffer->changes.pending)
+					{
+						merged_.Record(change);
+					}
+					buffer->changes.Clear();
+				}
+
+				for (auto& change : merged_.pending)
+				{
+					uint32_t typeId = TypeId(change.type);
+					if (typeId >= classes_.size())
+					{
+						continue;
+					}
+					ClassEntry& entry = classes_[typeId];
+					if (change.member < entry.members.size())
+					{
+						for (auto& sub : entry.members[change.member])
+						{
+							deliveries_.push_back(Delivery{ sub, change });
+						}
+					}
+					for (auto& sub : entry.all)
+					{
+						deliveries_.push_back(Delivery{ sub, change });
+					}
+				}
+				merged_.Clear();
+			}
+
+			for (auto& delivery : deliveries_)
+			{
+				auto& change = delivery.change;
+				delivery.sub.func(delivery.sub.user, change.object, change.type, change.member);
+			}
+
+			// every buffer keeps its capacity, steady state frames do not allocate.
+			deliveries_.clear();
+		}
+
+		// changes recorded and not flushed yet, counted per thread.
+		size_t Pending()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			size_t count = 0;
+			for (auto& buffer : buffers_)
+			{
+				std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+				count += buffer->changes.pending.size();
+			}
+			return count;
+		}
+
+	private:
+		struct ClassEntry
+		{
+			std::vector<std::vector<Subscriber>> members;
+			std::vector<Subscriber> all;
+		};
+
+		struct Change
+		{
+			void* object;
+			const Type* type;
+			uint32_t member;
+
+			bool operator==(const Change& o) const { return object == o.object && type == o.type && member == o.member; }
+		};
+
+		struct Delivery
+		{
+			Subscriber sub;
+			Change change;
+		};
+
+		// coalescing set, open addressing over indices into pending (0 is empty).
+		struct ChangeSet
+		{
+			std::vector<Change> pending;
+			std::vector<uint32_t> slots;
+
+			void Record(const Change& change)
+			{
+				// keep the load factor at or below one half.
+				if ((pending.size() + 1) * 2 > slots.size())
+				{
+					slots.assign(slots.empty() ? 64 : slots.size() * 2, 0);
+					for (uint32_t i = 0; i < pending.size(); i++)
+					{
+						slots[find_slot(pending[i])] = i + 1;
+					}
+				}
+
+				size_t slot = find_slot(change);
+				if (slots[slot] == 0)
+				{
+					pending.push_back(change);
+					slots[slot] = static_cast<uint32_t>(pending.size());
+				}
+			}
+
+			void Clear()
+			{
+				if (!pending.empty())
+				{
+					pending.clear();
+					std::fill(slots.begin(), slots.end(), 0);
+				}
+			}
+
+		private:
+			static size_t hash(const Change& change)
+			{
+				size_t h = reinterpret_cast<uintptr_t>(change.object) * 0x9E3779B97F4A7C15ull;
+				h ^= reinterpret_cast<uintptr_t>(change.type) + (h << 6) + (h >> 2);
+				return h ^ (change.member * 0xFF51AFD7ED558CCDull);
+			}
+
+			size_t find_slot(const Change& change) const
+			{
+				size_t mask = slots.size() - 1;
+				size_t idx = hash(change) & mask;
+				while (slots[idx] != 0 && !(pending[slots[idx] - 1] == change))
+				{
+					idx = (idx + 1) & mask;
+				}
+				return idx;
+			}
+		};
+
+		// one per thread, handed to a new thread once its owner exits.
+		// what an exited thread recorded is still delivered by the next Flush.
+		struct Buffer
+		{
+			std::mutex mutex;
+			ChangeSet changes;
+			std::atomic<bool> owned{ true };
+		};
+
+		struct Owner
+		{
+			Buffer* buffer;
+
+			~Owner() { buffer->owned.store(false, std::memory_order_release); }
+		};
+
+		// subscription counts by type id, chunks are allocated once and never move.
+		std::atomic<std::atomic<uint32_t>*> chunks_[MaxChunks] = {};
+		std::vector<ClassEntry> classes_;
+		uint32_t nextId_ = 1;
+		std::mutex mutex_;
+
+		std::vector<std::unique_ptr<Buffer>> buffers_;
+		std::mutex flushMutex_;
+		ChangeSet merged_;
+		std::vector<Delivery> deliveries_;
+
+		Hub() = default;
+
+		~Hub()
+		{
+			for (auto& chunk : chunks_)
+			{
+				delete[] chunk.load(std::memory_order_relaxed);
+			}
+		}
+
+		// called with mutex_ held.
+		std::atomic<uint32_t>& watch(uint32_t typeId)
+		{
+			auto& slot = chunks_[typeId >> ChunkBits];
+			std::atomic<uint32_t>* chunk = slot.load(std::memory_order_relaxed);
+			if (!chunk)
+			{
+				chunk = new std::atomic<uint32_t>[ChunkSize]();
+				slot.store(chunk, std::memory_order_release);
+			}
+			return chunk[typeId & (ChunkSize - 1)];
+		}
+
+		Buffer& local()
+		{
+			static thread_local Owner owner{ adopt() };
+			return *owner.buffer;
+		}
+
+		Buffer* adopt()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto& buffer : buffers_)
+			{
+				bool expected = false;
+				if (buffer->owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+				{
+					return buffer.get();
+				}
+			}
+			buffers_.push_back(std::make_unique<Buffer>());
+			return buffers_.back().get();
+		}
+
+		bool erase(std::vector<Subscriber>& list, uint32_t id)
+		{
+			for (size_t i = 0; i < list.size(); i++)
+			{
+				if (list[i].id == id)
+				{
+					list.erase(list.begin() + i);
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+}
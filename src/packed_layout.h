@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Layout of a pack of values stored by decreasing alignment, ties kept in
+// declaration order, so the pack carries at most its tail padding.
+// packed_offsets<Args...>()[i] is the offset of the i-th declared argument,
+// the last entry is the size rounded up to the largest alignment. Message
+// argument buffers and packed_tuple both use it.
+
+template<typename ...Args>
+constexpr std::array<size_t, sizeof...(Args) + 1> packed_offsets()
+{
+	constexpr size_t count = sizeof...(Args);
+	const size_t sizes[] = { sizeof(Args)..., 0 };
+	const size_t aligns[] = { alignof(Args)..., 1 };
+
+	// stable insertion sort of the declaration indices by alignment.
+	size_t order[count + 1] = {};
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t j = i;
+		for (; j > 0 && aligns[order[j - 1]] < aligns[i]; j--)
+		{
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+	}
+
+	std::array<size_t, count + 1> offsets{};
+	size_t offset = 0;
+	size_t align = 1;
+	for (size_t slot = 0; slot < count; slot++)
+	{
+		size_t idx = order[slot];
+		offset = (offset + aligns[idx] - 1) / aligns[idx] * aligns[idx];
+		offsets[idx] = offset;
+		offset += sizes[idx];
+		align = aligns[idx] > align ? aligns[idx] : align;
+	}
+	offsets[count] = (offset + align - 1) / align * align;
+	return offsets;
+}
+
+template<typename ...Args>
+constexpr size_t packed_size = packed_offsets<Args...>()[sizeof...(Args)];
+
+template<typename ...Args>
+constexpr size_t packed_align = std::max({ size_t(1), alignof(Args)... });
+
+// Tuple whose elements are stored by decreasing alignment, so it carries at
+// most the tail padding. get<I> still uses the declaration index, the slot
+// offset of every index is resolved at compile time by packed_offsets.
+// PackArgs writes message arguments as a packed_tuple.
+template<typename ...Args>
+class packed_tuple
+{
+	template<size_t I>
+	using element = std::tuple_element_t<I, std::tuple<Args...>>;
+
+	static constexpr auto layout = packed_offsets<Args...>();
+
+public:
+	template<size_t I>
+	static constexpr size_t offset = layout[I];
+
+	packed_tuple() : packed_tuple(Args{}...) {}
+
+	packed_tuple(const Args&... args)
+	{
+		construct(std::index_sequence_for<Args...>(), args...);
+	}
+
+	packed_tuple(const packed_tuple& o)
+	{
+		copy(o, std::index_sequence_for<Args...>());
+	}
+
+	packed_tuple& operator=(const packed_tuple& o)
+	{
+		assign(o, std::index_sequence_for<Args...>());
+		return *this;
+	}
+
+	~packed_tuple()
+	{
+		destroy(std::index_sequence_for<Args...>());
+	}
+
+	template<size_t I>
+	auto& get() { return *std::launder(reinterpret_cast<element<I>*>(storage_ + offset<I>)); }
+
+	template<size_t I>
+	auto& get() const { return *std::launder(reinterpret_cast<const element<I>*>(storage_ + offset<I>)); }
+
+private:
+	alignas(packed_align<Args...>) unsigned char storage_[packed_size<Args...> ? packed_size<Args...> : 1];
+
+	template<size_t ...Idx>
+	void construct(std::index_sequence<Idx...>, const Args&... args)
+	{
+		(new (storage_ + offset<Idx>) Args(args), ...);
+	}
+
+	template<size_t ...Idx>
+	void copy(const packed_tuple& o, std::index_sequence<Idx...>)
+	{
+		(new (storage_ + offset<Idx>) Args(o.get<Idx>()), ...);
+	}
+
+	template<size_t ...Idx>
+	void assign(const packed_tuple& o, std::index_sequence<Idx...>)
+	{
+		((get<Idx>() = o.get<Idx>()), ...);
+	}
+
+	template<size_t ...Idx>
+	void destroy(std::index_sequence<Idx...>)
+	{
+		(get<Idx>().~Args(), ...);
+	}
+};
+
+template<size_t I, typename ...Args>
+auto& get(packed_tuple<Args...>& tuple)
+{
+	return tuple.template get<I>();
+}
+
+template<size_t I, typename ...Args>
+auto& get(const packed_tuple<Args...>& tuple)
+{
+	return tuple.template get<I>();
+}
+
+namespace detail {
+
+	template<typename Tuple>
+	struct decay_tuple;
+
+	template<typename ...Args>
+	struct decay_tuple<std::tuple<Args...>>
+	{
+		using type = std::tuple<std::decay_t<Args>...>;
+	};
+
+	template<typename>
+	struct packed_args;
+
+	template<typename ...Args>
+	struct packed_args<std::tuple<Args...>>
+	{
+		using type = packed_tuple<std::decay_t<Args>...>;
+	};
+}
+
+// argument buffer for a reflected function, e.g. packed_args_t<function_traits<decltype(&Person::GetMarried)>>.
+template<typename Traits>
+using packed_args_t = typename detail::packed_args<typename Traits::args>::type;
@@ -0,0 +1,426 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Allocation of heap boxed any payloads.
+// Every payload goes through one pluggable Allocator. The default one keeps
+// thread local slabs per power of two size class, so workers do not meet on
+// the global heap. An Arena made current with ArenaScope takes over for
+// trivially destructible payloads and drops them all at once when it resets.
+
+namespace payload {
+
+	struct Allocator
+	{
+		void*(*allocate)(size_t size, size_t align) = {};
+		void(*deallocate)(void* ptr, size_t size, size_t align) = {};
+	};
+
+	// Slabs are SlabSize aligned and start with a header naming the thread
+	// heap that carved them. A block freed by its owner goes straight back on
+	// the slab's free list; one freed on another thread is pushed on the slab's
+	// atomic remote list, which the owner collects when it runs dry. A slab
+	// whose blocks have all come back is released, except the last one of its
+	// size class. The heap of an exited thread is kept, with its remaining
+	// slabs, for the next thread that starts.
+	class Pool final
+	{
+	public:
+		static constexpr size_t MinClass = 16;
+		static constexpr size_t MaxClass = 4096;
+		static constexpr size_t ClassCount = 9;
+		static constexpr size_t SlabSize = 64 * 1024;
+
+		static void* Allocate(size_t size, size_t align)
+		{
+			size_t idx = class_of(size, align);
+			if (idx == ClassCount)
+			{
+				return ::operator new(size, std::align_val_t(align));
+			}
+
+			Heap& heap = Local();
+			Slab* slab = heap.slabs[idx];
+			if (!slab || !slab->free)
+			{
+				slab = refill(heap, idx);
+			}
+			Node* node = slab->free;
+			slab->free = node->next;
+			slab->used++;
+			return node;
+		}
+
+		static void Deallocate(void* ptr, size_t size, size_t align)
+		{
+			size_t idx = class_of(size, align);
+			if (idx == ClassCount)
+			{
+				::operator delete(ptr, std::align_val_t(align));
+				return;
+			}
+
+			Slab* slab = Slab::Of(ptr);
+			Node* node = static_cast<Node*>(ptr);
+			if (slab->owner != &Local())
+			{
+				node->next = slab->remote.load(std::memory_order_relaxed);
+				while (!slab->remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+				return;
+			}
+
+			node->next = slab->free;
+			slab->free = node;
+			if (--slab->used == 0 && slab != slab->owner->slabs[idx])
+			{
+				release(*slab->owner, slab);
+			}
+		}
+
+		// slabs currently held, for tests and tools.
+		static size_t SlabCount()
+		{
+			return slabCount().load(std::memory_order_relaxed);
+		}
+
+	private:
+		struct Node
+		{
+			Node* next;
+		};
+
+		struct Heap;
+
+		struct Slab
+		{
+			Heap* owner;
+			Slab* prev;
+			Slab* next;
+			Node* free;
+			std::atomic<Node*> remote;
+			uint32_t used;
+			uint32_t idx;
+
+			static Slab* Of(void* ptr)
+			{
+				return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t(SlabSize - 1));
+			}
+		};
+
+		// per size class, a list of slabs whose head is allocated from.
+		struct Heap
+		{
+			Slab* slabs[ClassCount] = {};
+			Heap* nextOrphan = nullptr;
+		};
+
+		// adopts an orphaned heap if there is one, and orphans it on thread exit.
+		struct Owner
+		{
+			Heap* heap;
+
+			Owner() : heap(adopt()) {}
+
+			~Owner()
+			{
+				for (size_t i = 0; i < ClassCount; i++)
+				{
+					for (Slab* slab = heap->slabs[i]; slab;)
+					{
+						Slab* next = slab->next;
+						collect(slab);
+						if (slab->used == 0)
+						{
+							release(*heap, slab);
+						}
+						slab = next;
+					}
+				}
+
+				Orphans& orphans = GetOrphans();
+				std::lock_guard<std::mutex> lock(orphans.mutex);
+				heap->nextOrphan = orphans.head;
+				orphans.head = heap;
+			}
+		};
+
+		// never destroyed, remote frees may reach an orphan's slabs at any time.
+		struct Orphans
+		{
+			std::mutex mutex;
+			Heap* head = nullptr;
+		};
+
+		static Orphans& GetOrphans()
+		{
+			static Orphans* orphans = new Orphans();
+			return *orphans;
+		}
+
+		static std::atomic<size_t>& slabCount()
+		{
+			static std::atomic<size_t> count{ 0 };
+			return count;
+		}
+
+		static Heap* adopt()
+		{
+			Orphans& orphans = GetOrphans();
+			std::lock_guard<std::mutex> lock(orphans.mutex);
+			if (Heap* heap = orphans.head)
+			{
+				orphans.head = heap->nextOrphan;
+				heap->nextOrphan = nullptr;
+				return heap;
+			}
+			return new Heap();
+		}
+
+		static Heap& Local()
+		{
+			static thread_local Owner owner;
+			return *owner.heap;
+		}
+
+		static size_t class_of(size_t size, size_t align)
+		{
+			size_t bytes = std::max({ size, align, MinClass });
+			size_t idx = 0;
+			for (size_t cls = MinClass; cls < bytes; cls <<= 1)
+			{
+				idx++;
+			}
+			return std::min(idx, ClassCount);
+		}
+
+		// blocks freed on other threads join the slab's own list.
+		static void collect(Slab* slab)
+		{
+			Node* node = slab->remote.exchange(nullptr, std::memory_order_acquire);
+			while (node)
+			{
+				Node* next = node->next;
+				node->next = slab->free;
+				slab->free = node;
+				slab->used--;
+				node = next;
+			}
+		}
+
+		static void unlink(Heap& heap, Slab* slab)
+		{
+			(slab->prev ? slab->prev->next : heap.slabs[slab->idx]) = slab->next;
+			if (slab->next)
+			{
+				slab->next->prev = slab->prev;
+			}
+		}
+
+		static void push_front(Heap& heap, Slab* slab)
+		{
+			slab->prev = nullptr;
+			slab->next = heap.slabs[slab->idx];
+			if (slab->next)
+			{
+				slab->next->prev = slab;
+			}
+			heap.slabs[slab->idx] = slab;
+		}
+
+		static void release(Heap& heap, Slab* slab)
+		{
+			unlink(heap, slab);
+			slab->~Slab();
+			::operator delete(slab, std::align_val_t(SlabSize));
+			slabCount().fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		// the head slab ran dry: find one with free or remotely freed blocks,
+		// releasing empty ones on the way, or carve a new one.
+		static Slab* refill(Heap& heap, size_t idx)
+		{
+			for (Slab* slab = heap.slabs[idx]; slab;)
+			{
+				Slab* next = slab->next;
+				collect(slab);
+				if (slab->used == 0 && (slab->prev || slab->next))
+				{
+					release(heap, slab);
+				}
+				else if (slab->free)
+				{
+					unlink(heap, slab);
+					push_front(heap, slab);
+					return slab;
+				}
+				slab = next;
+			}
+
+			// blocks are aligned to their own size class, the header takes the first ones.
+			size_t cls = MinClass << idx;
+			char* memory = static_cast<char*>(::operator new(SlabSize, std::align_val_t(SlabSize)));
+			Slab* slab = new (memory) Slab{ &heap, nullptr, nullptr, nullptr, { nullptr }, 0, uint32_t(idx) };
+			size_t first = (sizeof(Slab) + cls - 1) / cls * cls;
+			for (size_t offset = SlabSize; offset - cls >= first; offset -= cls)
+			{
+				Node* node = reinterpret_cast<Node*>(memory + offset - cls);
+				node->next = slab->free;
+				slab->free = node;
+			}
+			slabCount().fetch_add(1, std::memory_order_relaxed);
+			push_front(heap, slab);
+			return slab;
+		}
+	};
+
+	inline Allocator& Current()
+	{
+		static Allocator allocator{ &Pool::Allocate, &Pool::Deallocate };
+		return allocator;
+	}
+
+	// install before the first payload is created, blocks must go back to the allocator that made them.
+	inline void SetAllocator(Allocator allocator)
+	{
+		Current() = allocator;
+	}
+
+	template<typename T, typename ...Args>
+	T* New(Args&&... args)
+	{
+		void* ptr = Current().allocate(sizeof(T), alignof(T));
+		return new (ptr) T{ std::forward<Args>(args)... };
+	}
+
+	template<typename T>
+	void Delete(T* ptr)
+	{
+		ptr->~T();
+		Current().deallocate(ptr, sizeof(T), alignof(T));
+	}
+
+	// Bump allocator, nothing is freed one by one. Reset keeps the first block
+	// so a scope that runs every frame or request stops allocating after warm up.
+	class Arena final
+	{
+	public:
+		explicit Arena(size_t blockSize = 64 * 1024) : blockSize_(blockSize) {}
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		~Arena()
+		{
+			for (auto& block : blocks_)
+			{
+				free_block(block);
+			}
+		}
+
+		void* Allocate(size_t size, size_t align)
+		{
+			char* ptr = align_up(cursor_, align);
+			if (!cursor_ || ptr + size > end_)
+			{
+				add_block(size + align);
+				ptr = align_up(cursor_, align);
+			}
+			cursor_ = ptr + size;
+			return ptr;
+		}
+
+		template<typename T, typename ...Args>
+		T* New(Args&&... args)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "arena payloads are never destroyed");
+			return new (Allocate(sizeof(T), alignof(T))) T{ std::forward<Args>(args)... };
+		}
+
+		void Reset()
+		{
+			for (size_t i = 1; i < blocks_.size(); i++)
+			{
+				free_block(blocks_[i]);
+			}
+			blocks_.resize(std::min<size_t>(blocks_.size(), 1));
+			cursor_ = blocks_.empty() ? nullptr : blocks_[0].data;
+			end_ = blocks_.empty() ? nullptr : blocks_[0].data + blocks_[0].size;
+		}
+
+		static Arena*& Current()
+		{
+			static thread_local Arena* current = nullptr;
+			return current;
+		}
+
+	private:
+		struct Block
+		{
+			char* data;
+			size_t size;
+		};
+
+		std::vector<Block> blocks_;
+		size_t blockSize_;
+		char* cursor_ = nullptr;
+		char* end_ = nullptr;
+
+		static char* align_up(char* ptr, size_t align)
+		{
+			return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(ptr) + align - 1) & ~uintptr_t(align - 1));
+		}
+
+		void add_block(size_t minSize)
+		{
+			size_t size = std::max(blockSize_, minSize);
+			blocks_.push_back(Block{ static_cast<char*>(::operator new(size, std::align_val_t(alignof(std::max_align_t)))), size });
+			cursor_ = blocks_.back().data;
+			end_ = cursor_ + size;
+		}
+
+		static void free_block(const Block& block)
+		{
+			::operator delete(block.data, std::align_val_t(alignof(std::max_align_t)));
+		}
+	};
+
+	// Makes an arena current for this thread. Trivially destructible payloads
+	// created inside the scope live in it and are dropped together on exit;
+	// those values must not outlive the scope.
+	class ArenaScope final
+	{
+	public:
+		explicit ArenaScope(Arena& arena) : arena_(arena), previous_(Arena::Current())
+		{
+			Arena::Current() = &arena_;
+		}
+
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+
+		~ArenaScope()
+		{
+			Arena::Current() = previous_;
+			arena_.Reset();
+		}
+
+	private:
+		Arena& arena_;
+		Arena* previous_;
+	};
+
+	// whether a payload of T created now goes to the current arena.
+	template<typename T>
+	bool InArena()
+	{
+		return std::is_trivially_destructible_v<T> && Arena::Current() != nullptr;
+	}
+}
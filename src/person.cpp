@@ -0,0 +1,4 @@
+#include "person.h"
+
+REFLECT_INSTANTIATE_ENUM(MyEnum)
+REFLECT_INSTANTIATE_CLASS(Person)
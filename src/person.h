@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include "reflect.h"
+
+// The demo types. With REFLECT_EXPLICIT_INSTANTIATION their factories and
+// payload helpers are compiled once, in person.cpp, and 03.cpp only calls them.
+
+struct Person final
+{
+	std::string familyName;
+	float height;
+	bool isFemale;
+
+	void IntroduceMyself() const {}
+	bool IsFemale() const { return false; }
+	bool GetMarried(Person& other)
+	{
+		bool success = other.isFemale != isFemale;
+		if (isFemale)
+		{
+			familyName = "Mrs." + other.familyName;
+		}
+		else
+		{
+			familyName = "Mr." + familyName;
+		}
+		return success;
+	}
+};
+
+enum class MyEnum
+{
+	value1 = 1,
+	value2 = 2,
+};
+
+BEGIN_STATIC_ENUM(MyEnum)
+	static_item(value1)
+	static_item(value2)
+END_STATIC_ENUM(MyEnum)
+
+BEGIN_STATIC_CLASS(Person)
+	static_var(familyName)
+	static_var(height)
+	static_var(isFemale)
+END_STATIC_CLASS(Person)
+
+REFLECT_EXTERN_ENUM(MyEnum)
+REFLECT_EXTERN_CLASS(Person)
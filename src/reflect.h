@@ -0,0 +1,3340 @@
+#pragma once
+#include <type_traits>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <string_view>
+#include "function_traits.h"
+#include "member_name.h"
+#include "variable_traits.h"
+#include "static_reflect.h"
+#include "epoch.h"
+#include "thread_pool.h"
+#include "mpmc_queue.h"
+#include "handle_pool.h"
+#include "snapshot.h"
+#include "layout.h"
+#include "payload_allocator.h"
+#include "observer.h"
+#include "memory_stats.h"
+#include "packed_layout.h"
+
+class Type;
+class any;
+
+template<typename T>
+any make_copy(const T& elem);
+
+template<typename T>
+any make_steal(T&&);
+
+template<typename T>
+any make_ref(T&);
+
+template<typename T>
+any make_cref(const T&);
+
+template<typename T>
+any make_share(T&&);
+
+class any
+{
+public:
+	enum class storage_type
+	{
+		Empty,
+		Copy,
+		Steal,
+		Ref,
+		ConstRef,
+		Shared,
+	};
+
+	struct operations
+	{
+		any(*copy)(const any&) = {};
+		any(*steal)(any&) = {};
+		void(*release)(any&) = {};
+		void(*unshare)(any&) = {};
+	};
+
+	any() = default;
+
+	// a copied reference refers to the same object, anything else takes the
+	// storage mode of the payload ops.copy made, so it is released as that.
+	any(const any& o)
+		: typeInfo_{ o.typeInfo_ }
+		, store_type{ o.store_type }
+		, ops{ o.ops }
+	{
+		if (store_type == storage_type::Ref || store_type == storage_type::ConstRef)
+		{
+			payload_ = o.payload_;
+		}
+		else if (ops.copy)
+		{
+			auto new_any = ops.copy(o);
+			payload_ = new_any.payload_;
+			store_type = new_any.store_type;
+			ops = new_any.ops;
+			new_any.payload_ = nullptr;
+			new_any.ops.release = nullptr;
+		}
+		else
+		{
+			store_type = storage_type::Empty;
+			typeInfo_ = nullptr;
+		}
+	}
+
+	// the source is left empty, so the payload is released once.
+	any(any&& o)
+		: typeInfo_(o.typeInfo_)
+		, payload_(o.payload_)
+		, store_type(o.store_type)
+		, ops(o.ops)
+	{
+		o.typeInfo_ = nullptr;
+		o.payload_ = nullptr;
+		o.store_type = storage_type::Empty;
+		o.ops = operations{};
+	}
+
+	any& operator=(any o)
+	{
+		std::swap(typeInfo_, o.typeInfo_);
+		std::swap(payload_, o.payload_);
+		std::swap(store_type, o.store_type);
+		std::swap(ops, o.ops);
+		return *this;
+	}
+
+	~any()
+	{
+		if (ops.release &&
+			(store_type == storage_type::Copy ||
+				store_type == storage_type::Steal ||
+				store_type == storage_type::Shared))
+		{
+			ops.release(*this);
+		}
+	}
+
+	// a shared payload is immutable, take a private copy before writing to it.
+	void detach()
+	{
+		if (store_type == storage_type::Shared && ops.unshare)
+		{
+			ops.unshare(*this);
+		}
+	}
+
+	const Type* typeInfo_ = nullptr;
+	void* payload_ = nullptr;
+	storage_type store_type = storage_type::Empty;
+	operations ops;
+private:
+};
+
+class Numeric;
+class Enum;
+class Class;
+
+class Type
+{
+public:
+	enum class Kind
+	{
+		Numeric,
+		Enum,
+		Class,
+	};
+
+	// One published description of a type. Registration edits a copy and
+	// publishes it as a whole; the Type object itself never moves, so a
+	// const Type* stays the identity of T across reloads.
+	struct Data
+	{
+		virtual ~Data() = default;
+
+		std::string name;
+		uint32_t version = 0;
+	};
+
+	virtual ~Type()
+	{
+		if (auto slot = find_slot(id_))
+		{
+			slot->store(nullptr, std::memory_order_release);
+		}
+		delete data_.load(std::memory_order_relaxed);
+	}
+
+	Type(const Type&) = delete;
+	Type& operator=(const Type&) = delete;
+
+	// readers must hold an epoch::Guard while they use the returned reference.
+	auto& GetName() const { return current().name; }
+	auto GetKind() const { return kind_; }
+	auto GetVersion() const { return current().version; }
+
+	// dense process wide index, fixed for the life of the Type like its address.
+	uint32_t GetId() const { return id_; }
+
+	// the Type whose GetId() is id, null if there is none. One load per level,
+	// safe while other threads create types.
+	static const Type* FromId(uint32_t id)
+	{
+		auto slot = find_slot(id);
+		return slot ? slot->load(std::memory_order_acquire) : nullptr;
+	}
+
+	const Numeric* AsNumeric() const
+	{
+		if (kind_ == Kind::Numeric)
+		{
+			return reinterpret_cast<const Numeric*>(this);
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	const Enum* AsEnum() const
+	{
+		if (kind_ == Kind::Enum)
+		{
+			return reinterpret_cast<const Enum*>(this);
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	const Class* AsClass() const
+	{
+		if (kind_ == Kind::Class)
+		{
+			return reinterpret_cast<const Class*>(this);
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+protected:
+	Type(Kind kind, Data* data) : data_(data), kind_(kind)
+	{
+		std::lock_guard<std::mutex> lock(registry().mutex);
+		auto& chunk = registry().chunks[id_ >> IdChunkBits];
+		if (!chunk.load(std::memory_order_relaxed))
+		{
+			chunk.store(new std::atomic<const Type*>[IdChunkSize](), std::memory_order_release);
+		}
+		find_slot(id_)->store(this, std::memory_order_release);
+	}
+
+	const Data& current() const { return *data_.load(std::memory_order_acquire); }
+
+	// writers are serialized by their factory. The old version is retired and
+	// freed once no reader that could have loaded it is left.
+	void publish(Data* data)
+	{
+		const Data* old = data_.load(std::memory_order_relaxed);
+		data->version = old->version + 1;
+		data_.store(data, std::memory_order_seq_cst);
+		epoch::Domain::Instance().Retire(const_cast<Data*>(old));
+	}
+
+private:
+	std::atomic<const Data*> data_;
+	uint32_t id_ = next_id();
+	Kind kind_;
+
+	// ids index chunks of slots allocated on first use and never freed.
+	static constexpr uint32_t IdChunkBits = 10;
+	static constexpr uint32_t IdChunkSize = 1u << IdChunkBits;
+	static constexpr uint32_t IdChunks = 64;
+
+	struct Registry
+	{
+		std::atomic<std::atomic<const Type*>*> chunks[IdChunks] = {};
+		std::mutex mutex;
+	};
+
+	static Registry& registry()
+	{
+		static Registry inst;
+		return inst;
+	}
+
+	static std::atomic<const Type*>* find_slot(uint32_t id)
+	{
+		auto chunk = id < IdChunks * IdChunkSize ? registry().chunks[id >> IdChunkBits].load(std::memory_order_acquire) : nullptr;
+		return chunk ? chunk + (id & (IdChunkSize - 1)) : nullptr;
+	}
+
+	static uint32_t next_id()
+	{
+		static std::atomic<uint32_t> next{ 0 };
+		uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+		assert(id < IdChunks * IdChunkSize);
+		return id;
+	}
+};
+
+inline uint32_t observe::TypeId(const Type* type)
+{
+	return type->GetId();
+}
+
+class Numeric : public Type
+{
+public:
+
+	enum class Kind {
+		Unkonwn, 
+		Int8, 
+		Int16, 
+		Int32, 
+		Int64, 
+		Int128,
+		Float, 
+		Double
+	};
+
+	Numeric(Kind kind, bool isSigned) : Type(Type::Kind::Numeric, named(getName(kind))),  kind_(kind), isSigned_(isSigned) {}
+
+	auto GetKind() const { return kind_; }
+	bool isSigned() const { return isSigned_; }
+
+	void SetValue(double value, any& elem)
+	{
+		if (elem.typeInfo_->GetKind() == Type::Kind::Numeric)
+		{
+			switch (elem.typeInfo_->AsNumeric()->GetKind())
+			{
+			case Kind::Int8:
+				*(char*)elem.payload_ = value;
+			default:
+				break;
+			}
+		}
+	}
+
+	template<typename T>
+	static Numeric Create()
+	{
+		return Numeric{ detectKind<T>(), std::is_signed_v<T> };
+	}
+
+private:
+
+	Kind kind_;
+	bool isSigned_;
+
+	// a numeric type is described once and never republished.
+	static Data* named(std::string name)
+	{
+		Data* data = new Data;
+		data->name = std::move(name);
+		return data;
+	}
+
+	static std::string getName(Kind kind)
+	{
+		switch (kind)
+		{
+		case Kind::Int8:
+			return "int8";
+		case Kind::Int16:
+			return "int16";
+		case Kind::Int32:
+			return "int32";
+		case Kind::Int64:
+			return "int64";
+		case Kind::Int128:
+			return "int128";
+		case Kind::Float:
+			return "float";
+		case Kind::Double:
+			return "double";
+		case Kind::Unkonwn:
+			break;
+		}
+
+		return "Unknown";
+	}
+
+	template<typename T>
+	static Kind detectKind()
+	{
+		if constexpr (std::is_same_v<T, char>)
+		{
+			return Kind::Int8;
+		}
+		else if constexpr (std::is_same_v<T, short>)
+		{
+			return Kind::Int16;
+		}
+		else if constexpr (std::is_same_v<T, int>)
+		{
+			return Kind::Int32;
+		}
+		else if constexpr (std::is_same_v<T, long>)
+		{
+			return Kind::Int64;
+		}
+		else if constexpr (std::is_same_v<T, long long>)
+		{
+			return Kind::Int128;
+		}
+		else if constexpr (std::is_same_v<T, float>)
+		{
+			return Kind::Float;
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			return Kind::Double;
+		}
+		else
+		{
+			return Kind::Unkonwn;
+		}
+	}
+};
+
+class Enum : public Type
+{
+public:
+	struct Item
+	{
+		using value_type = uint64_t;
+		std::string name;
+		value_type value;
+	};
+
+	// one version of the item list, EnumFactory edits a copy and publishes it.
+	struct Data : Type::Data
+	{
+		std::vector<Item> items;
+
+		template<typename T>
+		void Add(const std::string& name, T value)
+		{
+			items.push_back(Item{ name, static_cast<typename Item::value_type>(value) });
+		}
+
+		size_t MemoryUsage() const
+		{
+			size_t bytes = sizeof(Data) + name.capacity() + items.capacity() * sizeof(Item);
+			for (auto& item : items)
+			{
+				bytes += item.name.capacity();
+			}
+			return bytes;
+		}
+	};
+
+	explicit Enum(bool isSigned) : Type(Type::Kind::Enum, new Data), isSigned_(isSigned) {}
+
+	// signedness of the underlying type, items are stored widened to uint64.
+	bool isSigned() const { return isSigned_; }
+
+	// the current version as a whole, hold an epoch::Guard while using it.
+	const Data& Current() const { return static_cast<const Data&>(current()); }
+
+	auto& GetItems() const { return Current().items; }
+
+	size_t MemoryUsage() const { return sizeof(Enum) + Current().MemoryUsage(); }
+
+private:
+	template<typename T>
+	friend class EnumFactory;
+
+	bool isSigned_;
+};
+
+// type erased member pointer plus a thunk that knows its real type.
+// Bound once per member, then called per row without boxing any argument.
+struct BoundInvoker
+{
+	using thunk_type = void(*)(const BoundInvoker&, void* instance, const void* const* columns, size_t row);
+
+	thunk_type thunk = {};
+	alignas(std::max_align_t) unsigned char storage[32] = {};
+
+	template<typename Ptr>
+	static BoundInvoker Create(Ptr ptr, thunk_type thunk)
+	{
+		static_assert(sizeof(Ptr) <= sizeof(storage) && std::is_trivially_copyable_v<Ptr>);
+		BoundInvoker invoker;
+		invoker.thunk = thunk;
+		std::memcpy(invoker.storage, &ptr, sizeof(Ptr));
+		return invoker;
+	}
+
+	template<typename Ptr>
+	Ptr Get() const
+	{
+		Ptr ptr;
+		std::memcpy(&ptr, storage, sizeof(Ptr));
+		return ptr;
+	}
+
+	void operator()(void* instance, const void* const* columns, size_t row) const
+	{
+		thunk(*this, instance, columns, row);
+	}
+};
+
+// offsets of Args in an argument buffer, by declaration index, laid out by
+// packed_offsets. Returns the packed size.
+template<typename ...Args>
+size_t packed_layout(uint32_t* offsets)
+{
+	constexpr auto layout = packed_offsets<std::decay_t<Args>...>();
+	for (size_t i = 0; i < sizeof...(Args); i++)
+	{
+		offsets[i] = static_cast<uint32_t>(layout[i]);
+	}
+	return layout[sizeof...(Args)];
+}
+
+template<typename Tuple>
+struct tuple_layout;
+
+template<typename ...Args>
+struct tuple_layout<std::tuple<Args...>>
+{
+	static size_t Get(uint32_t* offsets) { return packed_layout<Args...>(offsets); }
+};
+
+namespace detail {
+
+	// write arguments as a packed_tuple into a buffer aligned to max_align_t,
+	// the offsets Dispatch reads come from the same packed_layout. Arguments are
+	// trivially copyable, so the tuple is never destroyed.
+	template<typename ...Args>
+	void pack_args(void* buffer, const Args&... args)
+	{
+		static_assert((std::is_trivially_copyable_v<Args> && ...), "message arguments must be trivially copyable");
+		new (buffer) packed_tuple<Args...>(args...);
+	}
+}
+
+class Member 
+{
+public:
+	virtual ~Member() = default;
+	virtual any call(const std::vector<any>& anies) const = 0;
+	virtual BoundInvoker Bind() const = 0;
+	virtual size_t ArgLayout(uint32_t* offsets) const = 0;
+};
+
+// Bind a stored value to a parameter of type Param without an extra copy:
+// T& and const T& refer to the payload, T&& moves out of it, and a by value
+// parameter is constructed once straight from the payload.
+template<typename Param>
+decltype(auto) unwarp(const any& value)
+{
+	using traits = param_traits<Param>;
+	using T = typename traits::value_type;
+
+	assert(value.typeInfo_ == GetType<T>());
+	assert(!traits::is_mutable || value.store_type != any::storage_type::ConstRef);
+	assert(!traits::is_mutable || value.store_type != any::storage_type::Shared);
+
+	T& elem = *static_cast<T*>(value.payload_);
+
+	if constexpr (traits::category == value_category::RValueRef)
+	{
+		return std::move(elem);
+	}
+	else if constexpr (traits::category == value_category::ConstLValueRef)
+	{
+		return static_cast<const T&>(elem);
+	}
+	else
+	{
+		return (elem);
+	}
+}
+
+template<typename Ptr, size_t ...Idx>
+any inner_call(Ptr ptr, const std::vector<any>& params, std::index_sequence<Idx...>)
+{
+	using traits = function_traits<Ptr>;
+	using clazz = typename traits::class_type;
+	using args = typename traits::args;
+
+	auto& instance = *static_cast<clazz*>(params[0].payload_);
+
+	auto invoke = [&]() -> decltype(auto)
+	{
+		if constexpr (traits::ref == ref_qualifier::RValue)
+		{
+			return (std::move(instance).*ptr)(unwarp<std::tuple_element_t<Idx, args>>(params[Idx + 1])...);
+		}
+		else
+		{
+			return (instance.*ptr)(unwarp<std::tuple_element_t<Idx, args>>(params[Idx + 1])...);
+		}
+	};
+
+	if constexpr (std::is_void_v<typename traits::return_type>)
+	{
+		invoke();
+		return any();
+	}
+	else if constexpr (std::is_reference_v<typename traits::return_type>)
+	{
+		return make_copy(invoke());
+	}
+	else
+	{
+		return make_steal(invoke());
+	}
+}
+
+// element row of a contiguous column of Param, as the reference category Param asks for.
+template<typename Param>
+decltype(auto) column_arg(const void* column, size_t row)
+{
+	using value_type = std::decay_t<Param>;
+	value_type& elem = const_cast<value_type*>(static_cast<const value_type*>(column))[row];
+
+	if constexpr (std::is_rvalue_reference_v<Param>)
+	{
+		return std::move(elem);
+	}
+	else
+	{
+		return (elem);
+	}
+}
+
+// columns[i] is a contiguous array of the i-th parameter, the result is dropped.
+template<typename Ptr, size_t ...Idx>
+void bound_call(void* instance, Ptr ptr, const void* const* columns, size_t row, std::index_sequence<Idx...>)
+{
+	using traits = function_traits<Ptr>;
+	using clazz = typename traits::class_type;
+	using args = typename traits::args;
+
+	auto& obj = *static_cast<clazz*>(instance);
+	if constexpr (traits::ref == ref_qualifier::RValue)
+	{
+		(std::move(obj).*ptr)(column_arg<std::tuple_element_t<Idx, args>>(columns[Idx], row)...);
+	}
+	else
+	{
+		(obj.*ptr)(column_arg<std::tuple_element_t<Idx, args>>(columns[Idx], row)...);
+	}
+}
+
+// One member variable. The member pointer lives type erased in the setter,
+// the getter and address thunks created next to it know its real type.
+class MemberVariable : public Member
+{
+public:
+	std::string_view name;
+	const Type* type = nullptr;
+	size_t size = 0;
+
+	// getter, anies[0] is the instance.
+	virtual any call(const std::vector<any>& anies) const override
+	{
+		assert(anies.size() == 1);
+		return getter_(setter_, anies[0]);
+	}
+
+	// setter, columns[0] is a contiguous array of the variable's type.
+	virtual BoundInvoker Bind() const override
+	{
+		return setter_;
+	}
+
+	virtual size_t ArgLayout(uint32_t* offsets) const override
+	{
+		return layout_(offsets);
+	}
+
+	// the setter itself, without the copy Bind() returns.
+	const BoundInvoker& Setter() const { return setter_; }
+
+	// the member inside instance, for members no static table gives an offset.
+	void* Address(void* instance) const { return address_(setter_, instance); }
+
+	template<typename Ptr>
+	static MemberVariable Create(Ptr ptr, std::string_view name);
+
+private:
+	BoundInvoker setter_;
+	any(*getter_)(const BoundInvoker& self, const any& instance) = {};
+	void*(*address_)(const BoundInvoker& self, void* instance) = {};
+	size_t(*layout_)(uint32_t* offsets) = {};
+};
+
+class MemberFunction : public Member
+{
+public:
+	std::string_view name;
+	const Type* retType = nullptr;
+
+	// points at one static array per signature, nothing is allocated per method.
+	static_reflect::basic_table<const Type*> paramType = { nullptr, 0 };
+
+	virtual any call(const std::vector<any>& anies) const override
+	{
+		assert(anies.size() == paramType.size() + 1);
+
+		for (size_t i = 0; i < paramType.size(); i++)
+		{
+			assert(paramType[i] == anies[i + 1].typeInfo_);
+		}
+
+		return caller_(invoker_, anies);
+	}
+
+	// columns[i] is a contiguous array of the i-th parameter, the result is dropped.
+	virtual BoundInvoker Bind() const override
+	{
+		return invoker_;
+	}
+
+	virtual size_t ArgLayout(uint32_t* offsets) const override
+	{
+		return layout_(offsets);
+	}
+
+	template<typename Ptr>
+	static MemberFunction Create(Ptr ptr, std::string_view name);
+
+private:
+	BoundInvoker invoker_;
+	any(*caller_)(const BoundInvoker& self, const std::vector<any>& anies) = {};
+	size_t(*layout_)(uint32_t* offsets) = {};
+
+	template<typename Params, size_t ...Idx>
+	static static_reflect::basic_table<const Type*> ConvertTypeList2Vector(std::index_sequence<Idx...>);
+};
+
+// Member attributes are a fixed set of four flags plus one typed value, the
+// Range of a Ranged member. The set is closed on purpose: Freeze() caches the
+// member list of every one of the 16 flag combinations, so GetVariable(mask)
+// is a lookup, and bits outside the four are ignored. A new attribute is a
+// new Flag here, which doubles MaskCount, and a new typed value gets a side
+// table next to the ranges.
+namespace attr {
+
+	// one bit per attribute, a member stores them all in one mask.
+	enum Flag : uint32_t
+	{
+		None       = 0,
+		Transient  = 1 << 0,
+		Replicated = 1 << 1,
+		EditorOnly = 1 << 2,
+		Ranged     = 1 << 3,
+	};
+
+	constexpr uint32_t FlagCount = 4;
+	constexpr uint32_t MaskCount = 1 << FlagCount;
+	static_assert(Ranged < MaskCount, "every Flag must fit the cached masks");
+
+	struct Range
+	{
+		double min;
+		double max;
+	};
+
+	// attributes given at registration, e.g. attr::replicated | attr::range(0, 3).
+	struct Set
+	{
+		uint32_t mask = None;
+		Range range = {};
+	};
+
+	constexpr Set transient{ Transient };
+	constexpr Set replicated{ Replicated };
+	constexpr Set editor_only{ EditorOnly };
+
+	constexpr Set range(double min, double max)
+	{
+		return Set{ Ranged, Range{ min, max } };
+	}
+
+	constexpr Set operator|(Set a, Set b)
+	{
+		return Set{ a.mask | b.mask, (b.mask & Ranged) ? b.range : a.range };
+	}
+}
+
+namespace visit {
+
+	// enum and nested class members are handed over as typed views, runtime
+	// registration does not keep their C++ type.
+	struct EnumRef
+	{
+		void* data;
+		size_t size;
+		const Enum* info;
+
+		uint64_t Get() const
+		{
+			uint64_t value = 0;
+			std::memcpy(&value, data, size);
+			return value;
+		}
+
+		void Set(uint64_t value) const { std::memcpy(data, &value, size); }
+	};
+
+	// typeId is the nested class's Type::GetId(), Info() resolves it.
+	struct ClassRef
+	{
+		void* data;
+		uint32_t typeId;
+
+		const Class* Info() const
+		{
+			auto type = Type::FromId(typeId);
+			return type ? type->AsClass() : nullptr;
+		}
+	};
+
+	// every member a visitor can receive, the slot of a member is its index here.
+	using field_types = std::tuple<
+		bool, char, signed char, unsigned char, short, unsigned short, int, unsigned int,
+		long, unsigned long, long long, unsigned long long, float, double, std::string,
+		EnumRef, ClassRef>;
+
+	constexpr uint8_t EnumSlot = std::tuple_size_v<field_types> - 2;
+	constexpr uint8_t ClassSlot = std::tuple_size_v<field_types> - 1;
+	constexpr uint8_t SkipSlot = 0xFF;
+
+	struct Slot
+	{
+		uint8_t slot;
+		uint8_t size;
+	};
+
+	template<size_t ...Idx>
+	uint8_t exact_slot(const Type* type, std::index_sequence<Idx...>)
+	{
+		uint8_t slot = SkipSlot;
+		((slot == SkipSlot && type == GetType<std::tuple_element_t<Idx, field_types>>() ? slot = Idx : 0), ...);
+		return slot;
+	}
+
+	// resolved once per class version, visiting never looks at the kind again.
+	inline Slot Classify(const Type* type, size_t size)
+	{
+		uint8_t slot = exact_slot(type, std::make_index_sequence<EnumSlot>());
+		if (slot == SkipSlot && type->GetKind() == Type::Kind::Enum && size <= sizeof(uint64_t))
+		{
+			slot = EnumSlot;
+		}
+		else if (slot == SkipSlot && type->GetKind() == Type::Kind::Class)
+		{
+			slot = ClassSlot;
+		}
+		return Slot{ slot, static_cast<uint8_t>(size) };
+	}
+}
+
+// hot record of a member variable, 16 bytes so four share a cache line.
+struct VariableRecord
+{
+	static constexpr uint32_t InvalidOffset = ~0u;
+
+	const Type* type;
+	uint32_t offset;
+	uint32_t attrs;
+};
+
+// Immutable packed metadata of one kind of member of a class, one 64 byte
+// aligned block: the hot records first, then the cold ones (name, range), the
+// Member objects handed out by GetVariable() / GetFunctions(), the ranges and
+// the name characters. A scan over the hot records touches nothing else.
+// Copies share the block.
+template<typename Hot, typename Object>
+class PackedMembers
+{
+public:
+	struct Cold
+	{
+		std::string_view name;
+		const attr::Range* range;
+	};
+
+	size_t size() const { return count_; }
+	size_t Bytes() const { return bytes_; }
+	const Hot* begin() const { return hot(); }
+	const Hot* end() const { return hot() + count_; }
+	const Hot& operator[](size_t idx) const { return hot()[idx]; }
+
+	const Cold& GetCold(size_t idx) const { return cold()[idx]; }
+	auto& Objects() const { return objects_; }
+
+	// names and ranges are copied in, the block does not point back at its inputs.
+	// hot(idx) makes the hot record, range(idx) is the range of the member or null.
+	template<typename MakeHot, typename Range>
+	static PackedMembers Build(const std::vector<Object>& objects, MakeHot&& hot, Range&& range)
+	{
+		PackedMembers table;
+		table.count_ = static_cast<uint32_t>(objects.size());
+
+		size_t nameBytes = 0;
+		for (auto& object : objects)
+		{
+			nameBytes += object.name.size();
+		}
+
+		size_t coldOffset = align_up(sizeof(Hot) * table.count_, alignof(Cold));
+		size_t objectOffset = align_up(coldOffset + sizeof(Cold) * table.count_, alignof(Object));
+		size_t rangeOffset = align_up(objectOffset + sizeof(Object) * table.count_, alignof(attr::Range));
+		size_t nameOffset = rangeOffset + sizeof(attr::Range) * table.count_;
+		size_t size = nameOffset + nameBytes;
+
+		table.block_ = std::shared_ptr<unsigned char>(static_cast<unsigned char*>(::operator new(size, std::align_val_t(64))), [](unsigned char* ptr)
+		{
+			::operator delete(ptr, std::align_val_t(64));
+		});
+		table.bytes_ = size;
+		table.coldOffset_ = static_cast<uint32_t>(coldOffset);
+
+		unsigned char* block = table.block_.get();
+		Object* copies = reinterpret_cast<Object*>(block + objectOffset);
+		char* names = reinterpret_cast<char*>(block + nameOffset);
+		for (uint32_t i = 0; i < table.count_; i++)
+		{
+			auto& object = objects[i];
+			const attr::Range* objectRange = range(i);
+			attr::Range* rangeCopy = objectRange ? new (block + rangeOffset + sizeof(attr::Range) * i) attr::Range(*objectRange) : nullptr;
+			std::string_view name(names, object.name.size());
+			std::memcpy(names, object.name.data(), object.name.size());
+			names += object.name.size();
+
+			new (block + sizeof(Hot) * i) Hot(hot(i));
+			new (block + coldOffset + sizeof(Cold) * i) Cold{ name, rangeCopy };
+			new (copies + i) Object(object);
+			copies[i].name = name;
+		}
+		table.objects_ = { copies, table.count_ };
+		return table;
+	}
+
+private:
+	// the objects hold nothing that needs destroying, the block is freed as is.
+	static_assert(std::is_trivially_destructible_v<Hot>);
+
+	std::shared_ptr<unsigned char> block_;
+	size_t bytes_ = 0;
+	uint32_t count_ = 0;
+	uint32_t coldOffset_ = 0;
+	static_reflect::basic_table<Object> objects_ = { nullptr, 0 };
+
+	static size_t align_up(size_t value, size_t align) { return (value + align - 1) & ~(align - 1); }
+
+	const Hot* hot() const { return reinterpret_cast<const Hot*>(block_.get()); }
+	const Cold* cold() const { return reinterpret_cast<const Cold*>(block_.get() + coldOffset_); }
+};
+
+using MemberTable = PackedMembers<VariableRecord, MemberVariable>;
+
+class Class : public Type
+{
+public:
+	static constexpr uint32_t InvalidMethod = ~0u;
+	static constexpr size_t MaxDispatchArgs = 8;
+	static constexpr size_t MaxDispatchArgBytes = 64;
+
+	// flat per method record, the method id is the index in GetFunctions().
+	// methods whose arguments do not fit a Message are listed but not packable.
+	struct DispatchEntry
+	{
+		BoundInvoker invoker;
+		uint32_t argc;
+		uint32_t argOffsets[MaxDispatchArgs];
+		size_t argSize;
+		bool packable;
+		uint32_t attrs;
+	};
+
+	using FunctionTable = PackedMembers<DispatchEntry, MemberFunction>;
+
+	// One version of the member lists. ClassFactory fills a draft, freezes it
+	// and publishes it; a published Data is never written again. Members are
+	// staged in plain vectors while drafting, Freeze() packs them into one
+	// MemberTable and one FunctionTable and drops the vectors.
+	class Data : public Type::Data
+	{
+	public:
+		Data() = default;
+
+		// a draft on top of other, its members staged again for more to be added.
+		explicit Data(const Data& other) : Type::Data(other), variables_(other.variables_), functions_(other.functions_)
+		{
+			for (size_t i = 0; i < variables_.size(); i++)
+			{
+				vars_.push_back(variables_.Objects()[i]);
+				add_attr(varAttrs_, varRanges_, static_cast<uint32_t>(i), attr::Set{ variables_[i].attrs, range_or_empty(variables_.GetCold(i).range) });
+			}
+			for (size_t i = 0; i < functions_.size(); i++)
+			{
+				funcs_.push_back(functions_.Objects()[i]);
+				add_attr(funcAttrs_, funcRanges_, static_cast<uint32_t>(i), attr::Set{ functions_[i].attrs, range_or_empty(functions_.GetCold(i).range) });
+			}
+		}
+
+		// a copy of a run time name, valid until Freeze() has packed it.
+		std::string_view Intern(std::string_view name)
+		{
+			return ownedNames_.emplace_back(name);
+		}
+
+		void AddVar(MemberVariable&& var, attr::Set attrs = {})
+		{
+			add_attr(varAttrs_, varRanges_, static_cast<uint32_t>(vars_.size()), attrs);
+			vars_.push_back(std::move(var));
+		}
+
+		void AddFunc(MemberFunction&& func, attr::Set attrs = {})
+		{
+			add_attr(funcAttrs_, funcRanges_, static_cast<uint32_t>(funcs_.size()), attrs);
+			funcs_.push_back(std::move(func));
+		}
+
+		auto& GetVariable() const { return variables_.Objects(); }
+		auto& GetFunctions() const { return functions_.Objects(); }
+		auto& GetDispatch() const { return functions_; }
+
+		uint32_t GetVariableAttr(size_t idx) const { return variables_[idx].attrs; }
+		uint32_t GetFunctionAttr(size_t idx) const { return functions_[idx].attrs; }
+		const attr::Range* GetVariableRange(size_t idx) const { return variables_.GetCold(idx).range; }
+		const attr::Range* GetFunctionRange(size_t idx) const { return functions_.GetCold(idx).range; }
+
+		auto& GetVariable(uint32_t mask) const { return varsByMask_[mask & (attr::MaskCount - 1)]; }
+		auto& GetFunctions(uint32_t mask) const { return funcsByMask_[mask & (attr::MaskCount - 1)]; }
+
+		auto& GetMembers() const { return variables_; }
+		auto& GetVisitSlots() const { return visitSlots_; }
+
+		// bytes held by this description, parameter type lists are static and not counted.
+		size_t MemoryUsage() const
+		{
+			size_t bytes = sizeof(Data) + name.capacity() + variables_.Bytes() + functions_.Bytes() + visitSlots_.capacity() * sizeof(visit::Slot);
+			bytes += vars_.capacity() * sizeof(MemberVariable) + funcs_.capacity() * sizeof(MemberFunction);
+			bytes += (varAttrs_.capacity() + funcAttrs_.capacity()) * sizeof(uint32_t);
+			bytes += (varRanges_.capacity() + funcRanges_.capacity()) * sizeof(range_table::value_type) + ownedNames_.size() * sizeof(std::string);
+			for (size_t mask = 0; mask < attr::MaskCount; mask++)
+			{
+				bytes += (varsByMask_[mask].capacity() + funcsByMask_[mask].capacity()) * sizeof(uint32_t);
+			}
+			return bytes;
+		}
+
+		// called once the class stops changing, the factory freezes every published version.
+		// layout, when the class also has a static table, supplies member offsets by name.
+		void Freeze(const static_reflect::Class* layout = nullptr)
+		{
+			build_masks(varsByMask_, varAttrs_);
+			build_masks(funcsByMask_, funcAttrs_);
+
+			visitSlots_.clear();
+			std::vector<uint32_t> offsets(vars_.size(), VariableRecord::InvalidOffset);
+			for (size_t i = 0; i < vars_.size(); i++)
+			{
+				auto var = layout ? layout->GetVariable().Find(vars_[i].name) : nullptr;
+				offsets[i] = var ? static_cast<uint32_t>(var->offset) : VariableRecord::InvalidOffset;
+				visitSlots_.push_back(visit::Classify(vars_[i].type, vars_[i].size));
+			}
+
+			variables_ = MemberTable::Build(vars_, [&](size_t idx)
+			{
+				return VariableRecord{ vars_[idx].type, offsets[idx], varAttrs_[idx] };
+			}, [&](size_t idx) { return find_range(varRanges_, idx); });
+
+			functions_ = FunctionTable::Build(funcs_, [&](size_t idx)
+			{
+				auto& func = funcs_[idx];
+				DispatchEntry entry{ func.Bind(), static_cast<uint32_t>(func.paramType.size()), {}, 0, false, funcAttrs_[idx] };
+				if (entry.argc <= MaxDispatchArgs)
+				{
+					entry.argSize = func.ArgLayout(entry.argOffsets);
+					entry.packable = entry.argSize <= MaxDispatchArgBytes;
+				}
+				return entry;
+			}, [&](size_t idx) { return find_range(funcRanges_, idx); });
+
+			// everything lives in the tables now.
+			vars_ = {};
+			funcs_ = {};
+			varAttrs_ = {};
+			funcAttrs_ = {};
+			varRanges_ = {};
+			funcRanges_ = {};
+			ownedNames_ = {};
+		}
+
+		uint32_t FindFunction(std::string_view name) const
+		{
+			for (size_t i = 0; i < functions_.size(); i++)
+			{
+				if (functions_.GetCold(i).name == name)
+				{
+					return static_cast<uint32_t>(i);
+				}
+			}
+			return InvalidMethod;
+		}
+
+	private:
+		using range_table = std::vector<std::pair<uint32_t, attr::Range>>;
+		using mask_lists = std::array<std::vector<uint32_t>, attr::MaskCount>;
+
+		// the draft, empty once frozen.
+		std::vector<MemberVariable> vars_;
+		std::vector<MemberFunction> funcs_;
+		std::vector<uint32_t> varAttrs_;
+		std::vector<uint32_t> funcAttrs_;
+		range_table varRanges_;
+		range_table funcRanges_;
+		std::deque<std::string> ownedNames_;
+
+		MemberTable variables_;
+		FunctionTable functions_;
+		mask_lists varsByMask_;
+		mask_lists funcsByMask_;
+		std::vector<visit::Slot> visitSlots_;
+
+		static void add_attr(std::vector<uint32_t>& attrs, range_table& ranges, uint32_t idx, attr::Set set)
+		{
+			attrs.push_back(set.mask);
+			if (set.mask & attr::Ranged)
+			{
+				ranges.emplace_back(idx, set.range);
+			}
+		}
+
+		static attr::Range range_or_empty(const attr::Range* range)
+		{
+			return range ? *range : attr::Range{};
+		}
+
+		// ranges are appended in member order, so the table is sorted by index.
+		static const attr::Range* find_range(const range_table& ranges, size_t idx)
+		{
+			auto it = std::lower_bound(ranges.begin(), ranges.end(), idx, [](auto& entry, size_t key) { return entry.first < key; });
+			return it != ranges.end() && it->first == idx ? &it->second : nullptr;
+		}
+
+		static void build_masks(mask_lists& lists, const std::vector<uint32_t>& attrs)
+		{
+			for (uint32_t mask = 0; mask < attr::MaskCount; mask++)
+			{
+				lists[mask].clear();
+				for (uint32_t i = 0; i < attrs.size(); i++)
+				{
+					if ((attrs[i] & mask) == mask)
+					{
+						lists[mask].push_back(i);
+					}
+				}
+			}
+		}
+	};
+
+	Class() : Type(Type::Kind::Class, new Data) {}
+
+	// the current version as a whole, hold an epoch::Guard while using it.
+	// Each accessor below loads the current version again, so take Current()
+	// once when several results have to agree with each other.
+	const Data& Current() const { return static_cast<const Data&>(current()); }
+
+	auto& GetVariable() const { return Current().GetVariable(); }
+	auto& GetFunctions() const { return Current().GetFunctions(); }
+	auto& GetDispatch() const { return Current().GetDispatch(); }
+
+	uint32_t GetVariableAttr(size_t idx) const { return Current().GetVariableAttr(idx); }
+	uint32_t GetFunctionAttr(size_t idx) const { return Current().GetFunctionAttr(idx); }
+	const attr::Range* GetVariableRange(size_t idx) const { return Current().GetVariableRange(idx); }
+	const attr::Range* GetFunctionRange(size_t idx) const { return Current().GetFunctionRange(idx); }
+
+	// indices of the members carrying every attribute in mask, cached by Freeze().
+	auto& GetVariable(uint32_t mask) const { return Current().GetVariable(mask); }
+	auto& GetFunctions(uint32_t mask) const { return Current().GetFunctions(mask); }
+
+	// packed variable metadata, built by Freeze(); GetVariable() are its Member objects.
+	auto& GetMembers() const { return Current().GetMembers(); }
+
+	// what VisitFields hands each member over as, parallel to GetMembers().
+	auto& GetVisitSlots() const { return Current().GetVisitSlots(); }
+
+	size_t MemoryUsage() const { return sizeof(Class) + Current().MemoryUsage(); }
+
+	uint32_t FindFunction(std::string_view name) const { return Current().FindFunction(name); }
+
+	// reflective setter, value points at an object of the variable's type.
+	// subscribers of the member hear about it on the next observe::Hub::Flush().
+	void SetVariable(void* obj, size_t idx, const void* value) const
+	{
+		epoch::Guard guard;
+		const void* columns[1] = { value };
+		Current().GetVariable()[idx].Setter()(obj, columns, 0);
+		observe::Hub::Instance().Notify(obj, this, static_cast<uint32_t>(idx));
+	}
+
+	// call method id on obj, decoding arguments in place from a PackArgs buffer.
+	// false, and nothing called, if the id is out of range or not packable.
+	bool Dispatch(void* obj, uint32_t methodId, const void* argBuffer) const
+	{
+		epoch::Guard guard;
+		auto& dispatch = Current().GetDispatch();
+		if (methodId >= dispatch.size() || !dispatch[methodId].packable)
+		{
+			return false;
+		}
+
+		const DispatchEntry& entry = dispatch[methodId];
+		const void* columns[MaxDispatchArgs];
+		for (uint32_t i = 0; i < entry.argc; i++)
+		{
+			columns[i] = static_cast<const unsigned char*>(argBuffer) + entry.argOffsets[i];
+		}
+		entry.invoker(obj, columns, 0);
+		return true;
+	}
+
+private:
+	template<typename T>
+	friend class ClassFactory;
+};
+
+// The factories declare their non template members here and define them
+// further down, out of the class: a member defined in the class is inline, and
+// REFLECT_EXTERN_* cannot keep other translation units from instantiating it.
+template<typename T>
+class NumericFactory final
+{
+public:
+	static NumericFactory& Instance();
+
+	const Numeric& Info() const;
+
+private:
+	Numeric info_;
+
+	NumericFactory();
+};
+
+template<typename T>
+class EnumFactory final
+{
+public:
+	// One batch of edits, published as a single new version when it goes out
+	// of scope. A chain like Regist(...).Add(...).Add(...) is one batch; the
+	// factory stays locked until then, so do not keep one alive across calls
+	// into the same factory.
+	class Registration final
+	{
+	public:
+		Registration(Registration&&) = default;
+		Registration& operator=(Registration&&) = delete;
+
+		~Registration();
+
+		template<typename U>
+		Registration& Add(const std::string& name, U value)
+		{
+			draft_->Add(name, value);
+			return *this;
+		}
+
+	private:
+		friend class EnumFactory;
+
+		std::unique_lock<std::mutex> lock_;
+		EnumFactory* factory_;
+		std::unique_ptr<Enum::Data> draft_;
+
+		Registration(EnumFactory& factory, bool keep);
+	};
+
+	static EnumFactory& Instance();
+
+	const Enum& Info() const;
+
+	Registration Regist(const std::string& name);
+
+	template<typename U>
+	Registration Add(const std::string& name, U value)
+	{
+		Registration batch(*this, true);
+		batch.Add(name, value);
+		return batch;
+	}
+
+	void UnRegist();
+
+private:
+	Enum info_{ std::is_signed_v<std::underlying_type_t<T>> };
+	std::mutex mutex_;
+};
+
+template<typename T>
+class ClassFactory final
+{
+public:
+	// One batch of edits, frozen and published as a single new version by
+	// Commit() or when it goes out of scope. A chain like
+	// Regist(...).AddVariable(...) is one batch; the factory stays locked until
+	// then, so do not keep one alive across calls into the same factory.
+	// Freezing copies and indexes every member, so add members in one batch:
+	// n single AddVariable calls on the factory are n batches and O(n^2).
+	class Registration final
+	{
+	public:
+		Registration(Registration&&) = default;
+		Registration& operator=(Registration&&) = delete;
+
+		~Registration();
+
+		// the end of registration: freeze, publish and unlock the factory now.
+		// the batch is empty afterwards and must not be added to.
+		void Commit();
+
+		// a run time name is copied until Freeze() packs it, a static_name such
+		// as member_name_of(&Class::member) is used as it is.
+		template<typename U>
+		Registration& AddVariable(U ptr, std::string_view name, attr::Set attrs = {})
+		{
+			return AddVariable(ptr, static_name{ draft_->Intern(name) }, attrs);
+		}
+
+		template<typename U>
+		Registration& AddVariable(U ptr, static_name name, attr::Set attrs = {})
+		{
+			draft_->AddVar(MemberVariable::Create(ptr, name.value), attrs);
+			return *this;
+		}
+
+		template<typename U>
+		Registration& AddFunction(U ptr, std::string_view name, attr::Set attrs = {})
+		{
+			return AddFunction(ptr, static_name{ draft_->Intern(name) }, attrs);
+		}
+
+		template<typename U>
+		Registration& AddFunction(U ptr, static_name name, attr::Set attrs = {})
+		{
+			draft_->AddFunc(MemberFunction::Create(ptr, name.value), attrs);
+			return *this;
+		}
+
+	private:
+		friend class ClassFactory;
+
+		std::unique_lock<std::mutex> lock_;
+		ClassFactory* factory_;
+		std::unique_ptr<Class::Data> draft_;
+
+		Registration(ClassFactory& factory, bool keep);
+	};
+
+	static ClassFactory& Instance();
+
+	const Class& Info() const;
+
+	Registration Regist(const std::string& name);
+
+	// a batch on top of the current version, for members added after Regist.
+	Registration Edit();
+
+	// one member as its own batch, a copy and a freeze per call; see Edit().
+	// Name is a std::string_view, copied, or a static_name, kept.
+	template<typename U, typename Name>
+	Registration AddVariable(U ptr, Name&& name, attr::Set attrs = {})
+	{
+		Registration batch(*this, true);
+		batch.AddVariable(ptr, std::forward<Name>(name), attrs);
+		return batch;
+	}
+
+	template<typename U, typename Name>
+	Registration AddFunction(U ptr, Name&& name, attr::Set attrs = {})
+	{
+		Registration batch(*this, true);
+		batch.AddFunction(ptr, std::forward<Name>(name), attrs);
+		return batch;
+	}
+
+	void UnRegist();
+
+private:
+	Class info_;
+	std::mutex mutex_;
+
+	static const static_reflect::Class* static_layout();
+};
+
+template<typename T>
+NumericFactory<T>& NumericFactory<T>::Instance()
+{
+	static NumericFactory inst;
+	return inst;
+}
+
+template<typename T>
+const Numeric& NumericFactory<T>::Info() const
+{
+	return info_;
+}
+
+template<typename T>
+NumericFactory<T>::NumericFactory() : info_(Numeric::Create<T>()) {}
+
+template<typename T>
+EnumFactory<T>::Registration::~Registration()
+{
+	if (draft_)
+	{
+		memstats::TrackMetadata<T>(sizeof(Enum) + draft_->MemoryUsage());
+		factory_->info_.publish(draft_.release());
+	}
+}
+
+template<typename T>
+EnumFactory<T>::Registration::Registration(EnumFactory& factory, bool keep) : lock_(factory.mutex_), factory_(&factory),
+	draft_(keep ? new Enum::Data(factory.info_.Current()) : new Enum::Data) {}
+
+template<typename T>
+EnumFactory<T>& EnumFactory<T>::Instance()
+{
+	static EnumFactory inst;
+	return inst;
+}
+
+template<typename T>
+const Enum& EnumFactory<T>::Info() const
+{
+	return info_;
+}
+
+template<typename T>
+typename EnumFactory<T>::Registration EnumFactory<T>::Regist(const std::string& name)
+{
+	Registration batch(*this, false);
+	batch.draft_->name = name;
+	return batch;
+}
+
+template<typename T>
+void EnumFactory<T>::UnRegist()
+{
+	Registration batch(*this, false);
+}
+
+template<typename T>
+ClassFactory<T>::Registration::~Registration()
+{
+	Commit();
+}
+
+template<typename T>
+void ClassFactory<T>::Registration::Commit()
+{
+	if (draft_)
+	{
+		draft_->Freeze(static_layout());
+		memstats::TrackMetadata<T>(sizeof(Class) + draft_->MemoryUsage());
+		factory_->info_.publish(draft_.release());
+		lock_.unlock();
+	}
+}
+
+template<typename T>
+ClassFactory<T>::Registration::Registration(ClassFactory& factory, bool keep) : lock_(factory.mutex_), factory_(&factory),
+	draft_(keep ? new Class::Data(factory.info_.Current()) : new Class::Data) {}
+
+template<typename T>
+ClassFactory<T>& ClassFactory<T>::Instance()
+{
+	static ClassFactory inst;
+	return inst;
+}
+
+template<typename T>
+const Class& ClassFactory<T>::Info() const
+{
+	return info_;
+}
+
+template<typename T>
+typename ClassFactory<T>::Registration ClassFactory<T>::Regist(const std::string& name)
+{
+	Registration batch(*this, false);
+	batch.draft_->name = name;
+	return batch;
+}
+
+template<typename T>
+typename ClassFactory<T>::Registration ClassFactory<T>::Edit()
+{
+	return Registration(*this, true);
+}
+
+template<typename T>
+void ClassFactory<T>::UnRegist()
+{
+	Registration batch(*this, false);
+}
+
+template<typename T>
+const static_reflect::Class* ClassFactory<T>::static_layout()
+{
+	if constexpr (has_static_type<T>::value)
+	{
+		return &GetStaticType<T>();
+	}
+	else
+	{
+		return nullptr;
+	}
+}
+
+class TrivialFactory
+{
+public:
+	static TrivialFactory& Instance()
+	{
+		static TrivialFactory inst;
+		return inst;
+	}
+};
+
+template<typename T>
+class Factory final
+{
+public:
+	static auto& GetFactory()
+	{
+		using type = std::remove_cv_t<std::remove_reference_t<T>>;
+
+		if constexpr (std::is_fundamental_v<type>)
+		{
+			return NumericFactory<type>::Instance();
+		}
+		else if constexpr (std::is_enum_v<type>)
+		{
+			return EnumFactory<type>::Instance();
+		}
+		else if constexpr (std::is_class_v<type>)
+		{
+			return ClassFactory<type>::Instance();
+		}
+	}
+};
+
+
+template<typename T>
+auto& Registrar()
+{
+	return Factory<T>::GetFactory();
+}
+
+template<typename T>
+const Type* GetType()
+{
+	return &Factory<T>::GetFactory().Info();
+}
+
+// Explicit instantiation mode, off unless REFLECT_EXPLICIT_INSTANTIATION is defined.
+// REFLECT_EXTERN_*(T) goes in the header that defines T, REFLECT_INSTANTIATE_*(T)
+// in exactly one .cpp that includes it (src/person.h and src/person.cpp). Every
+// other translation unit then calls the code compiled there, GetType<T>(), the
+// factory and the make_* helpers, instead of instantiating them for T again;
+// operations_traits<T> is only reached through the make_* helpers, so it
+// follows them. Member templates such as AddVariable are still instantiated
+// where they are used.
+#ifdef REFLECT_EXPLICIT_INSTANTIATION
+
+#define REFLECT_TYPE_TEMPLATES(prefix, T)   \
+	prefix any make_copy<T>(const T&);      \
+	prefix any make_steal<T>(T&&);          \
+	prefix any make_ref<T>(T&);             \
+	prefix any make_cref<T>(const T&);      \
+	prefix any make_share<T>(T&&);          \
+	prefix const Type* GetType<T>();
+
+#define REFLECT_EXTERN_NUMERIC(T)      REFLECT_TYPE_TEMPLATES(extern template, T) extern template class NumericFactory<T>;
+#define REFLECT_EXTERN_ENUM(T)         REFLECT_TYPE_TEMPLATES(extern template, T) extern template class EnumFactory<T>;
+#define REFLECT_EXTERN_CLASS(T)        REFLECT_TYPE_TEMPLATES(extern template, T) extern template class ClassFactory<T>;
+#define REFLECT_INSTANTIATE_NUMERIC(T) REFLECT_TYPE_TEMPLATES(template, T) template class NumericFactory<T>;
+#define REFLECT_INSTANTIATE_ENUM(T)    REFLECT_TYPE_TEMPLATES(template, T) template class EnumFactory<T>;
+#define REFLECT_INSTANTIATE_CLASS(T)   REFLECT_TYPE_TEMPLATES(template, T) template class ClassFactory<T>;
+
+#else
+
+#define REFLECT_EXTERN_NUMERIC(T)
+#define REFLECT_EXTERN_ENUM(T)
+#define REFLECT_EXTERN_CLASS(T)
+#define REFLECT_INSTANTIATE_NUMERIC(T)
+#define REFLECT_INSTANTIATE_ENUM(T)
+#define REFLECT_INSTANTIATE_CLASS(T)
+
+#endif
+
+namespace visit {
+
+	template<typename Visitor>
+	using thunk_type = void(*)(Visitor& visitor, std::string_view name, void* field, const Type* type, size_t size);
+
+	template<typename Visitor, typename U>
+	void thunk(Visitor& visitor, std::string_view name, void* field, const Type* type, size_t size)
+	{
+		if constexpr (std::is_same_v<U, EnumRef>)
+		{
+			EnumRef ref{ field, size, type->AsEnum() };
+			visitor(name, ref);
+		}
+		else if constexpr (std::is_same_v<U, ClassRef>)
+		{
+			ClassRef ref{ field, type->GetId() };
+			visitor(name, ref);
+		}
+		else
+		{
+			visitor(name, *static_cast<U*>(field));
+		}
+	}
+
+	template<typename Visitor, size_t ...Idx>
+	constexpr std::array<thunk_type<Visitor>, sizeof...(Idx)> make_thunks(std::index_sequence<Idx...>)
+	{
+		return { &thunk<Visitor, std::tuple_element_t<Idx, field_types>>... };
+	}
+
+	// one table per visitor type, indexed by slot.
+	template<typename Visitor>
+	inline constexpr auto thunks = make_thunks<Visitor>(std::make_index_sequence<std::tuple_size_v<field_types>>());
+}
+
+// Calls visitor(name, value) for every member of obj whose type is in
+// visit::field_types, where value is the member itself (U&) or an EnumRef /
+// ClassRef view. Each member is one table lookup and
+// one indirect call, nothing is boxed. Offsets come from the static table when
+// the class has one, other members are found through their address thunk.
+template<typename Visitor>
+void VisitFields(const Class& info, void* obj, Visitor&& visitor)
+{
+	epoch::Guard guard;
+	auto& table = visit::thunks<std::remove_reference_t<Visitor>>;
+	auto& data = info.Current();
+	auto& members = data.GetMembers();
+	auto& slots = data.GetVisitSlots();
+	char* base = static_cast<char*>(obj);
+
+	for (size_t i = 0; i < members.size(); i++)
+	{
+		if (slots[i].slot != visit::SkipSlot)
+		{
+			auto& member = members[i];
+			void* field = member.offset != VariableRecord::InvalidOffset ? base + member.offset : data.GetVariable()[i].Address(obj);
+			table[slots[i].slot](visitor, members.GetCold(i).name, field, member.type, slots[i].size);
+		}
+	}
+}
+
+template<typename T, typename Visitor>
+void VisitFields(T& obj, Visitor&& visitor)
+{
+	VisitFields(*GetType<T>()->AsClass(), &obj, std::forward<Visitor>(visitor));
+}
+
+// Apply one reflected setter or method to every instance of a contiguous array.
+// columns hold one contiguous array per argument (indexed like instances), or
+// nullptr when the method takes none. Work is split into chunks of grain rows.
+template<typename T>
+void BulkApply(T* instances, size_t count, const Member& member, const void* const* columns = nullptr, size_t grain = 4096, ThreadPool& pool = ThreadPool::Instance())
+{
+	const BoundInvoker invoker = member.Bind();
+
+	pool.ParallelFor(count, grain, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			invoker(&instances[i], columns, i);
+		}
+	});
+}
+
+namespace radix {
+
+	// map a field to an unsigned key whose order matches the field order.
+
+	template<typename U>
+	uint64_t key(const void* field)
+	{
+		U value;
+		std::memcpy(&value, field, sizeof(U));
+
+		if constexpr (std::is_floating_point_v<U>)
+		{
+			using bits_type = std::conditional_t<sizeof(U) == 4, uint32_t, uint64_t>;
+			constexpr bits_type sign = bits_type(1) << (sizeof(U) * 8 - 1);
+			bits_type bits;
+			std::memcpy(&bits, &value, sizeof(U));
+			return (bits & sign) ? bits_type(~bits) : bits_type(bits | sign);
+		}
+		else if constexpr (std::is_signed_v<U>)
+		{
+			using unsigned_type = std::make_unsigned_t<U>;
+			return unsigned_type(unsigned_type(value) ^ (unsigned_type(1) << (sizeof(U) * 8 - 1)));
+		}
+		else
+		{
+			return value;
+		}
+	}
+
+	using key_func = uint64_t(*)(const void*);
+
+	template<typename Signed, typename Unsigned>
+	key_func integer(bool isSigned)
+	{
+		return isSigned ? &key<Signed> : &key<Unsigned>;
+	}
+
+	// enums are keyed like their underlying type, nullptr when the member has no key.
+	inline key_func select(const Type* type, size_t size)
+	{
+		bool isSigned = true;
+
+		if (type->GetKind() == Type::Kind::Numeric)
+		{
+			auto numeric = type->AsNumeric();
+			if (numeric->GetKind() == Numeric::Kind::Float)
+			{
+				return &key<float>;
+			}
+			if (numeric->GetKind() == Numeric::Kind::Double)
+			{
+				return &key<double>;
+			}
+			isSigned = numeric->isSigned();
+		}
+		else if (type->GetKind() == Type::Kind::Enum)
+		{
+			isSigned = type->AsEnum()->isSigned();
+		}
+		else
+		{
+			return nullptr;
+		}
+
+		switch (size)
+		{
+		case 1:
+			return integer<int8_t, uint8_t>(isSigned);
+		case 2:
+			return integer<int16_t, uint16_t>(isSigned);
+		case 4:
+			return integer<int32_t, uint32_t>(isSigned);
+		case 8:
+			return integer<int64_t, uint64_t>(isSigned);
+		}
+
+		return nullptr;
+	}
+
+	// stable LSD radix sort of index by keys, a byte is skipped when all keys share it.
+	template<typename Index>
+	void sort(std::vector<uint64_t>& keys, std::vector<Index>& index)
+	{
+		std::vector<uint64_t> keysTmp(keys.size());
+		std::vector<Index> indexTmp(index.size());
+
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			size_t counts[257] = {};
+			for (uint64_t k : keys)
+			{
+				counts[((k >> shift) & 0xFF) + 1]++;
+			}
+
+			if (std::find(std::begin(counts), std::end(counts), keys.size()) != std::end(counts))
+			{
+				continue;
+			}
+
+			for (int i = 0; i < 256; i++)
+			{
+				counts[i + 1] += counts[i];
+			}
+
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				size_t dst = counts[(keys[i] >> shift) & 0xFF]++;
+				keysTmp[dst] = keys[i];
+				indexTmp[dst] = index[i];
+			}
+
+			keys.swap(keysTmp);
+			index.swap(indexTmp);
+		}
+	}
+}
+
+// Permutation that orders items by one member, chosen at run time:
+// items[result[0]] holds the smallest value. Keys are extracted once per item
+// in parallel, then radix sorted, so no any is built per comparison.
+// The index is empty when the member is not a numeric or enum field, or when
+// Index cannot address count items; uint32_t halves the memory of a full size_t.
+template<typename Index = uint32_t, typename T>
+std::vector<Index> BuildIndex(const T* items, size_t count, const static_reflect::Variable& member, ThreadPool& pool = ThreadPool::Instance())
+{
+	static_assert(std::is_unsigned_v<Index>, "the index type must be unsigned");
+
+	radix::key_func key = radix::select(member.type(), member.size);
+	if (!key || (count != 0 && count - 1 > std::numeric_limits<Index>::max()))
+	{
+		return {};
+	}
+
+	std::vector<uint64_t> keys(count);
+	std::vector<Index> index(count);
+
+	pool.ParallelFor(count, 1 << 16, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			keys[i] = key(reinterpret_cast<const char*>(&items[i]) + member.offset);
+			index[i] = static_cast<Index>(i);
+		}
+	});
+
+	radix::sort(keys, index);
+	return index;
+}
+
+// false, with items untouched, when the member cannot be sorted by.
+template<typename T>
+bool SortBy(T* items, size_t count, const static_reflect::Variable& member, ThreadPool& pool = ThreadPool::Instance())
+{
+	if (!radix::select(member.type(), member.size))
+	{
+		return false;
+	}
+
+	auto permute = [&](const auto& index)
+	{
+		std::vector<T> sorted;
+		sorted.reserve(count);
+		for (auto idx : index)
+		{
+			sorted.push_back(std::move(items[idx]));
+		}
+		std::move(sorted.begin(), sorted.end(), items);
+	};
+
+	if (count == 0 || count - 1 <= std::numeric_limits<uint32_t>::max())
+	{
+		permute(BuildIndex<uint32_t>(items, count, member, pool));
+	}
+	else
+	{
+		permute(BuildIndex<uint64_t>(items, count, member, pool));
+	}
+	return true;
+}
+
+namespace query {
+
+	// Predicates over registered members, e.g.
+	//   auto& info = GetStaticType<Person>();
+	//   auto pred  = Field(info, "height") > 1.8 && Field(info, "isFemale");
+	//   auto rows  = Compile(pred).Filter(people.data(), people.size());
+	// Compile resolves every leaf to an offset and a kernel specialized on the
+	// member type, so evaluation only runs tight loops over batches of rows.
+	// A leaf naming an unknown or non numeric member makes the whole query
+	// invalid: Compiled::Error() says why and Run() selects no row.
+
+	enum class Op
+	{
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		Equal,
+		NotEqual,
+	};
+
+	// integer constants are compared exactly against integer members, a
+	// double cannot hold every int64.
+	struct Constant
+	{
+		double real = 0;
+		int64_t integer = 0;
+		bool isInteger = false;
+
+		template<typename V>
+		static Constant From(V value)
+		{
+			if constexpr (std::is_integral_v<V>)
+			{
+				if (!std::is_signed_v<V> && static_cast<uint64_t>(value) > uint64_t(std::numeric_limits<int64_t>::max()))
+				{
+					return Constant{ static_cast<double>(value) };
+				}
+				return Constant{ static_cast<double>(value), static_cast<int64_t>(value), true };
+			}
+			else
+			{
+				return Constant{ static_cast<double>(value) };
+			}
+		}
+	};
+
+	struct Node
+	{
+		enum class Kind
+		{
+			Compare,
+			And,
+			Or,
+			Not,
+		};
+
+		Kind kind;
+		const static_reflect::Variable* member = nullptr;
+		Op op = Op::NotEqual;
+		Constant value;
+		std::shared_ptr<const Node> lhs;
+		std::shared_ptr<const Node> rhs;
+		std::string name;
+	};
+
+	class Expr
+	{
+	public:
+		Expr(std::shared_ptr<const Node> node) : node_(std::move(node)) {}
+
+		auto& GetNode() const { return *node_; }
+
+		friend Expr operator&&(const Expr& a, const Expr& b) { return Expr(std::make_shared<Node>(Node{ Node::Kind::And, nullptr, Op::NotEqual, {}, a.node_, b.node_, {} })); }
+		friend Expr operator||(const Expr& a, const Expr& b) { return Expr(std::make_shared<Node>(Node{ Node::Kind::Or, nullptr, Op::NotEqual, {}, a.node_, b.node_, {} })); }
+		friend Expr operator!(const Expr& a) { return Expr(std::make_shared<Node>(Node{ Node::Kind::Not, nullptr, Op::NotEqual, {}, a.node_, nullptr, {} })); }
+
+	private:
+		std::shared_ptr<const Node> node_;
+	};
+
+	// member is nullptr when the name is not registered, the query then fails to compile.
+	class FieldRef
+	{
+	public:
+		FieldRef(const static_reflect::Variable* member, std::string_view name) : member_(member), name_(name) {}
+
+		template<typename V>
+		Expr Compare(Op op, V value) const
+		{
+			static_assert(std::is_arithmetic_v<V>, "fields compare against numbers");
+			return Expr(std::make_shared<Node>(Node{ Node::Kind::Compare, member_, op, Constant::From(value), nullptr, nullptr, std::string(name_) }));
+		}
+
+		template<typename V> Expr operator<(V value) const { return Compare(Op::Less, value); }
+		template<typename V> Expr operator<=(V value) const { return Compare(Op::LessEqual, value); }
+		template<typename V> Expr operator>(V value) const { return Compare(Op::Greater, value); }
+		template<typename V> Expr operator>=(V value) const { return Compare(Op::GreaterEqual, value); }
+		template<typename V> Expr operator==(V value) const { return Compare(Op::Equal, value); }
+		template<typename V> Expr operator!=(V value) const { return Compare(Op::NotEqual, value); }
+
+		// a bare field tests for non zero.
+		operator Expr() const { return Compare(Op::NotEqual, 0); }
+
+	private:
+		const static_reflect::Variable* member_;
+		std::string_view name_;
+	};
+
+	inline FieldRef Field(const static_reflect::Class& info, std::string_view name)
+	{
+		return FieldRef(info.GetVariable().Find(name), name);
+	}
+
+	inline Expr operator&&(const FieldRef& a, const FieldRef& b) { return Expr(a) && Expr(b); }
+	inline Expr operator&&(const FieldRef& a, const Expr& b) { return Expr(a) && b; }
+	inline Expr operator&&(const Expr& a, const FieldRef& b) { return a && Expr(b); }
+	inline Expr operator||(const FieldRef& a, const FieldRef& b) { return Expr(a) || Expr(b); }
+	inline Expr operator||(const FieldRef& a, const Expr& b) { return Expr(a) || b; }
+	inline Expr operator||(const Expr& a, const FieldRef& b) { return a || Expr(b); }
+	inline Expr operator!(const FieldRef& a) { return !Expr(a); }
+
+	// out[i] = field(row i) op value, for one batch of rows.
+	using kernel_func = void(*)(const char* base, size_t stride, size_t count, const Constant& value, uint8_t* out);
+
+	template<Op O, typename L, typename R>
+	bool compare(L lhs, R rhs)
+	{
+		if constexpr (O == Op::Less)              return lhs < rhs;
+		else if constexpr (O == Op::LessEqual)    return lhs <= rhs;
+		else if constexpr (O == Op::Greater)      return lhs > rhs;
+		else if constexpr (O == Op::GreaterEqual) return lhs >= rhs;
+		else if constexpr (O == Op::Equal)        return lhs == rhs;
+		else                                      return lhs != rhs;
+	}
+
+	// Exact: an integer member against an integer constant, compared as
+	// integers. An unsigned member is never below a negative constant.
+	template<typename U, Op O, bool Exact>
+	void kernel(const char* base, size_t stride, size_t count, const Constant& value, uint8_t* out)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			U field;
+			std::memcpy(&field, base + i * stride, sizeof(U));
+
+			if constexpr (!Exact)
+			{
+				out[i] = compare<O>(static_cast<double>(field), value.real);
+			}
+			else if constexpr (std::is_signed_v<U>)
+			{
+				out[i] = compare<O>(static_cast<int64_t>(field), value.integer);
+			}
+			else
+			{
+				out[i] = value.integer < 0 ? compare<O>(1, 0) : compare<O>(static_cast<uint64_t>(field), static_cast<uint64_t>(value.integer));
+			}
+		}
+	}
+
+	template<typename U, Op O>
+	kernel_func integer(bool exact)
+	{
+		return exact ? &kernel<U, O, true> : &kernel<U, O, false>;
+	}
+
+	template<Op O>
+	kernel_func select(const Type* type, size_t size, bool exact)
+	{
+		bool isSigned = true;
+
+		if (type->GetKind() == Type::Kind::Numeric)
+		{
+			auto numeric = type->AsNumeric();
+			if (numeric->GetKind() == Numeric::Kind::Float)
+			{
+				return &kernel<float, O, false>;
+			}
+			if (numeric->GetKind() == Numeric::Kind::Double)
+			{
+				return &kernel<double, O, false>;
+			}
+			isSigned = numeric->isSigned();
+		}
+		else if (type->GetKind() == Type::Kind::Enum)
+		{
+			isSigned = type->AsEnum()->isSigned();
+		}
+		else
+		{
+			return nullptr;
+		}
+
+		switch (size)
+		{
+		case 1:
+			return isSigned ? integer<int8_t, O>(exact) : integer<uint8_t, O>(exact);
+		case 2:
+			return isSigned ? integer<int16_t, O>(exact) : integer<uint16_t, O>(exact);
+		case 4:
+			return isSigned ? integer<int32_t, O>(exact) : integer<uint32_t, O>(exact);
+		case 8:
+			return isSigned ? integer<int64_t, O>(exact) : integer<uint64_t, O>(exact);
+		}
+
+		return nullptr;
+	}
+
+	inline kernel_func select(Op op, const Type* type, size_t size, bool exact)
+	{
+		switch (op)
+		{
+		case Op::Less:
+			return select<Op::Less>(type, size, exact);
+		case Op::LessEqual:
+			return select<Op::LessEqual>(type, size, exact);
+		case Op::Greater:
+			return select<Op::Greater>(type, size, exact);
+		case Op::GreaterEqual:
+			return select<Op::GreaterEqual>(type, size, exact);
+		case Op::Equal:
+			return select<Op::Equal>(type, size, exact);
+		case Op::NotEqual:
+			return select<Op::NotEqual>(type, size, exact);
+		}
+
+		return nullptr;
+	}
+
+	// postfix program, every step works on whole batches of masks.
+	class Compiled
+	{
+	public:
+		static constexpr size_t Batch = 1024;
+
+		explicit Compiled(const Expr& expr)
+		{
+			depth_ = emit(expr.GetNode());
+			if (!error_.empty())
+			{
+				steps_.clear();
+			}
+		}
+
+		bool Valid() const { return error_.empty(); }
+
+		// empty when the query compiled.
+		const std::string& Error() const { return error_; }
+
+		// evaluate rows [0, count) of an array with the given stride, mask[i] is 0 or 1.
+		void Run(const void* items, size_t stride, size_t count, uint8_t* mask) const
+		{
+			if (!Valid())
+			{
+				std::memset(mask, 0, count);
+				return;
+			}
+
+			std::vector<uint8_t> stack(depth_ * Batch);
+			const char* base = static_cast<const char*>(items);
+
+			for (size_t begin = 0; begin < count; begin += Batch)
+			{
+				size_t n = std::min(Batch, count - begin);
+				size_t top = 0;
+
+				for (auto& step : steps_)
+				{
+					uint8_t* a = stack.data() + (top - (step.kind == Node::Kind::Compare ? 0 : step.kind == Node::Kind::Not ? 1 : 2)) * Batch;
+					uint8_t* b = a + Batch;
+
+					switch (step.kind)
+					{
+					case Node::Kind::Compare:
+						step.kernel(base + begin * stride + step.offset, stride, n, step.value, a);
+						top++;
+						break;
+					case Node::Kind::And:
+						for (size_t i = 0; i < n; i++) a[i] &= b[i];
+						top--;
+						break;
+					case Node::Kind::Or:
+						for (size_t i = 0; i < n; i++) a[i] |= b[i];
+						top--;
+						break;
+					case Node::Kind::Not:
+						for (size_t i = 0; i < n; i++) a[i] ^= 1;
+						break;
+					}
+				}
+
+				std::memcpy(mask + begin, stack.data(), n);
+			}
+		}
+
+		template<typename T>
+		std::vector<uint32_t> Filter(const T* items, size_t count) const
+		{
+			std::vector<uint8_t> mask(count);
+			Run(items, sizeof(T), count, mask.data());
+
+			std::vector<uint32_t> rows;
+			for (size_t i = 0; i < count; i++)
+			{
+				if (mask[i])
+				{
+					rows.push_back(static_cast<uint32_t>(i));
+				}
+			}
+			return rows;
+		}
+
+	private:
+		struct Step
+		{
+			Node::Kind kind;
+			kernel_func kernel = nullptr;
+			size_t offset = 0;
+			Constant value;
+		};
+
+		std::vector<Step> steps_;
+		size_t depth_ = 0;
+		std::string error_;
+
+		// returns how many batch masks the subtree needs on the stack.
+		size_t emit(const Node& node)
+		{
+			switch (node.kind)
+			{
+			case Node::Kind::Compare:
+			{
+				kernel_func kernel = node.member ? select(node.op, node.member->type(), node.member->size, node.value.isInteger) : nullptr;
+				if (!kernel && error_.empty())
+				{
+					error_ = node.member ? "member '" + node.name + "' is not a numeric or enum field" : "unknown member '" + node.name + "'";
+				}
+				steps_.push_back(Step{ node.kind, kernel, node.member ? node.member->offset : 0, node.value });
+				return 1;
+			}
+			case Node::Kind::Not:
+			{
+				size_t depth = emit(*node.lhs);
+				steps_.push_back(Step{ node.kind, nullptr, 0, {} });
+				return depth;
+			}
+			default:
+			{
+				size_t lhs = emit(*node.lhs);
+				size_t rhs = emit(*node.rhs) + 1;
+				steps_.push_back(Step{ node.kind, nullptr, 0, {} });
+				return std::max(lhs, rhs);
+			}
+			}
+		}
+	};
+
+	inline Compiled Compile(const Expr& expr)
+	{
+		return Compiled(expr);
+	}
+}
+
+// Polymorphic inline cache for calling a method by name from one call site.
+// The last few (receiver type, argument types) shapes map straight to the
+// resolved overload; only a miss walks Class::GetFunctions().
+class CallSite final
+{
+public:
+	static constexpr size_t Ways = 4;
+	static constexpr size_t MaxArgs = 6;
+
+	explicit CallSite(std::string name) : name_(std::move(name)) {}
+
+	// anies[0] is the receiver, the rest are the arguments.
+	any Call(const std::vector<any>& anies)
+	{
+		epoch::Guard guard;
+		const Member* member = Resolve(anies);
+		assert(member && "no overload matches the argument types");
+		return member->call(anies);
+	}
+
+	// the member belongs to the receiver's current version, hold an
+	// epoch::Guard for as long as it is used.
+	const Member* Resolve(const std::vector<any>& anies)
+	{
+		assert(!anies.empty());
+
+		if (anies.size() - 1 > MaxArgs)
+		{
+			misses_++;
+			return lookup(anies);
+		}
+
+		// match the entries against the arguments in place, a Shape is only built on a miss.
+		const Type* receiver = anies[0].typeInfo_;
+		uint32_t version = receiver->GetVersion();
+		size_t argc = anies.size() - 1;
+		for (auto& entry : entries_)
+		{
+			if (entry.member && entry.shape.Matches(receiver, version, anies))
+			{
+				hits_++;
+				return entry.member;
+			}
+		}
+
+		Shape shape;
+		shape.receiver = receiver;
+		shape.version = version;
+		shape.argc = static_cast<uint8_t>(argc);
+		for (size_t i = 0; i < argc; i++)
+		{
+			shape.args[i] = anies[i + 1].typeInfo_;
+		}
+
+		misses_++;
+		const Member* member = lookup(anies);
+		if (member)
+		{
+			entries_[next_++ % Ways] = Entry{ shape, member };
+		}
+		return member;
+	}
+
+	uint64_t Hits() const { return hits_; }
+	uint64_t Misses() const { return misses_; }
+
+	double HitRate() const
+	{
+		uint64_t total = hits_ + misses_;
+		return total ? double(hits_) / double(total) : 0.0;
+	}
+
+private:
+	struct Shape
+	{
+		const Type* receiver = nullptr;
+		uint32_t version = 0;
+		uint8_t argc = 0;
+		const Type* args[MaxArgs] = {};
+
+		bool Matches(const Type* type, uint32_t typeVersion, const std::vector<any>& anies) const
+		{
+			if (receiver != type || version != typeVersion || argc != anies.size() - 1)
+			{
+				return false;
+			}
+			for (size_t i = 0; i < argc; i++)
+			{
+				if (args[i] != anies[i + 1].typeInfo_)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	struct Entry
+	{
+		Shape shape;
+		const Member* member = nullptr;
+	};
+
+	std::string name_;
+	Entry entries_[Ways];
+	size_t next_ = 0;
+	uint64_t hits_ = 0;
+	uint64_t misses_ = 0;
+
+	// full resolution: same name, same arity, every parameter type matches.
+	const Member* lookup(const std::vector<any>& anies) const
+	{
+		const Class* info = anies[0].typeInfo_->AsClass();
+		if (!info)
+		{
+			return nullptr;
+		}
+
+		for (auto& func : info->GetFunctions())
+		{
+			if (func.name != name_ || func.paramType.size() != anies.size() - 1)
+			{
+				continue;
+			}
+
+			bool match = true;
+			for (size_t i = 0; match && i < func.paramType.size(); i++)
+			{
+				match = func.paramType[i] == anies[i + 1].typeInfo_;
+			}
+
+			if (match)
+			{
+				return &func;
+			}
+		}
+
+		return nullptr;
+	}
+};
+
+namespace migrate {
+
+	// Reads records written with an older member list into the live class.
+	// Build() matches stored and live members by name once and compiles the
+	// result into copy runs, numeric conversions and defaults; Run() then only
+	// executes those steps per record. Only numeric and enum members are
+	// migrated, class members keep whatever the destination holds.
+
+	enum class Scalar
+	{
+		None,
+		I8, U8, I16, U16, I32, U32, I64, U64,
+		F32, F64,
+		Count,
+	};
+
+	using scalar_types = std::tuple<void, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t, float, double>;
+
+	inline Scalar scalar(Type::Kind kind, Numeric::Kind numeric, bool isSigned, size_t size)
+	{
+		if (kind == Type::Kind::Numeric && numeric == Numeric::Kind::Float)
+		{
+			return Scalar::F32;
+		}
+		if (kind == Type::Kind::Numeric && numeric == Numeric::Kind::Double)
+		{
+			return Scalar::F64;
+		}
+		if (kind != Type::Kind::Numeric && kind != Type::Kind::Enum)
+		{
+			return Scalar::None;
+		}
+
+		switch (size)
+		{
+		case 1:
+			return isSigned ? Scalar::I8 : Scalar::U8;
+		case 2:
+			return isSigned ? Scalar::I16 : Scalar::U16;
+		case 4:
+			return isSigned ? Scalar::I32 : Scalar::U32;
+		case 8:
+			return isSigned ? Scalar::I64 : Scalar::U64;
+		}
+		return Scalar::None;
+	}
+
+	inline Scalar scalar(const snapshot::MemberRecord& member)
+	{
+		return scalar(Type::Kind(member.kind), Numeric::Kind(member.numeric & 0xFF), (member.numeric & snapshot::NumericSigned) != 0, member.size);
+	}
+
+	inline Scalar scalar(const static_reflect::Variable& var)
+	{
+		auto type = var.type();
+		auto numeric = type->AsNumeric();
+		auto enumInfo = type->AsEnum();
+		bool isSigned = numeric ? numeric->isSigned() : enumInfo && enumInfo->isSigned();
+		return scalar(type->GetKind(), numeric ? numeric->GetKind() : Numeric::Kind::Unkonwn, isSigned, var.size);
+	}
+
+	// converts one member of count records, src and dst advance by their strides.
+	using convert_func = void(*)(const char* src, size_t srcStride, char* dst, size_t dstStride, size_t count);
+
+	template<typename From, typename To>
+	void convert(const char* src, size_t srcStride, char* dst, size_t dstStride, size_t count)
+	{
+		for (size_t i = 0; i < count; i++, src += srcStride, dst += dstStride)
+		{
+			From from;
+			std::memcpy(&from, src, sizeof(From));
+			To to = static_cast<To>(from);
+			std::memcpy(dst, &to, sizeof(To));
+		}
+	}
+
+	inline void copy_bytes(const char* src, size_t srcStride, char* dst, size_t dstStride, size_t count, size_t size)
+	{
+		switch (size)
+		{
+		case 1:
+			return convert<uint8_t, uint8_t>(src, srcStride, dst, dstStride, count);
+		case 2:
+			return convert<uint16_t, uint16_t>(src, srcStride, dst, dstStride, count);
+		case 4:
+			return convert<uint32_t, uint32_t>(src, srcStride, dst, dstStride, count);
+		case 8:
+			return convert<uint64_t, uint64_t>(src, srcStride, dst, dstStride, count);
+		}
+		for (size_t i = 0; i < count; i++, src += srcStride, dst += dstStride)
+		{
+			std::memcpy(dst, src, size);
+		}
+	}
+
+	template<size_t From, size_t To>
+	constexpr convert_func convert_entry()
+	{
+		if constexpr (From == 0 || To == 0)
+		{
+			return nullptr;
+		}
+		else
+		{
+			return &convert<std::tuple_element_t<From, scalar_types>, std::tuple_element_t<To, scalar_types>>;
+		}
+	}
+
+	template<size_t From, size_t ...To>
+	constexpr std::array<convert_func, sizeof...(To)> convert_row(std::index_sequence<To...>)
+	{
+		return { convert_entry<From, To>()... };
+	}
+
+	template<size_t ...From>
+	constexpr auto convert_table(std::index_sequence<From...>)
+	{
+		using row_type = std::array<convert_func, sizeof...(From)>;
+		return std::array<row_type, sizeof...(From)>{ convert_row<From>(std::index_sequence<From...>())... };
+	}
+
+	inline convert_func converter(Scalar from, Scalar to)
+	{
+		static constexpr auto table = convert_table(std::make_index_sequence<size_t(Scalar::Count)>());
+		return table[size_t(from)][size_t(to)];
+	}
+
+	struct Step
+	{
+		enum class Kind
+		{
+			Copy,
+			Convert,
+			Default,
+		};
+
+		Kind kind;
+		uint32_t src;
+		uint32_t dst;
+		uint32_t size;
+		convert_func convert;
+	};
+
+	class Plan
+	{
+	public:
+		template<typename T>
+		static Plan Build(const snapshot::View& view, const snapshot::ClassRecord& stored)
+		{
+			static_assert(std::is_default_constructible_v<T>);
+
+			Plan plan;
+			plan.srcStride_ = stored.size;
+			plan.dstStride_ = sizeof(T);
+			plan.prototype_.resize(sizeof(T));
+			{
+				T prototype{};
+				std::memcpy(plan.prototype_.data(), &prototype, sizeof(T));
+			}
+
+			for (auto& var : GetStaticType<T>().GetVariable())
+			{
+				Scalar to = scalar(var);
+				if (to == Scalar::None)
+				{
+					continue;
+				}
+
+				// a stored member reaching past its record is treated as missing.
+				const snapshot::MemberRecord* member = view.FindVariable(stored, var.name);
+				if (member && uint64_t(member->offset) + member->size > stored.size)
+				{
+					member = nullptr;
+				}
+				Scalar from = member ? scalar(*member) : Scalar::None;
+
+				if (from == Scalar::None)
+				{
+					plan.push(Step{ Step::Kind::Default, 0, uint32_t(var.offset), uint32_t(var.size), nullptr });
+				}
+				else if (from == to)
+				{
+					plan.push(Step{ Step::Kind::Copy, member->offset, uint32_t(var.offset), uint32_t(var.size), nullptr });
+				}
+				else
+				{
+					plan.push(Step{ Step::Kind::Convert, member->offset, uint32_t(var.offset), uint32_t(var.size), converter(from, to) });
+				}
+			}
+
+			return plan;
+		}
+
+		auto& GetSteps() const { return steps_; }
+
+		// src holds count stored records back to back, dst count live objects.
+		template<typename T>
+		void Run(const void* src, size_t count, T* dst, ThreadPool& pool = ThreadPool::Instance()) const
+		{
+			assert(sizeof(T) == dstStride_);
+
+			pool.ParallelFor(count, 1 << 14, [&](size_t begin, size_t end)
+			{
+				run(static_cast<const char*>(src) + begin * srcStride_, end - begin, reinterpret_cast<char*>(dst + begin));
+			});
+		}
+
+	private:
+		std::vector<Step> steps_;
+		std::vector<char> prototype_;
+		size_t srcStride_ = 0;
+		size_t dstStride_ = 0;
+
+		// adjacent copies with matching gaps become one memcpy.
+		void push(const Step& step)
+		{
+			if (!steps_.empty() && step.kind == Step::Kind::Copy)
+			{
+				Step& last = steps_.back();
+				if (last.kind == Step::Kind::Copy && last.src + last.size == step.src && last.dst + last.size == step.dst)
+				{
+					last.size += step.size;
+					return;
+				}
+			}
+			steps_.push_back(step);
+		}
+
+		// step by step over blocks of records that stay in cache, so each step
+		// is one tight loop instead of a dispatch per field.
+		void run(const char* src, size_t count, char* dst) const
+		{
+			constexpr size_t Block = 256;
+			for (size_t begin = 0; begin < count; begin += Block)
+			{
+				size_t n = std::min(Block, count - begin);
+				const char* from = src + begin * srcStride_;
+				char* to = dst + begin * dstStride_;
+				for (auto& step : steps_)
+				{
+					switch (step.kind)
+					{
+					case Step::Kind::Copy:
+						copy_bytes(from + step.src, srcStride_, to + step.dst, dstStride_, n, step.size);
+						break;
+					case Step::Kind::Convert:
+						step.convert(from + step.src, srcStride_, to + step.dst, dstStride_, n);
+						break;
+					case Step::Kind::Default:
+						copy_bytes(prototype_.data() + step.dst, 0, to + step.dst, dstStride_, n, step.size);
+						break;
+					}
+				}
+			}
+		}
+	};
+}
+
+namespace csv {
+
+	// Bulk import of delimited text into an array of a registered class.
+	// The header row is matched against the static member table once, every
+	// column gets a parser picked from its Type, then the rows are split into
+	// newline aligned chunks and parsed in parallel straight into the members.
+	// Quoted fields are not supported.
+
+	struct Column;
+
+	using parse_func = bool(*)(std::string_view text, char* dst, const Column& column);
+
+	struct Column
+	{
+		parse_func parse = nullptr;
+		size_t offset = 0;
+		size_t size = 0;
+		const Enum* enumInfo = nullptr;
+	};
+
+	template<typename U>
+	bool parse_number(std::string_view text, char* dst, const Column&)
+	{
+		U value{};
+		auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+		std::memcpy(dst, &value, sizeof(U));
+		return result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+
+	inline bool parse_bool(std::string_view text, char* dst, const Column&)
+	{
+		bool value = text == "1" || text == "true";
+		*reinterpret_cast<bool*>(dst) = value;
+		return value || text == "0" || text == "false";
+	}
+
+	inline bool parse_string(std::string_view text, char* dst, const Column&)
+	{
+		reinterpret_cast<std::string*>(dst)->assign(text.data(), text.size());
+		return true;
+	}
+
+	inline bool parse_enum(std::string_view text, char* dst, const Column& column)
+	{
+		for (auto& item : column.enumInfo->GetItems())
+		{
+			if (item.name == text)
+			{
+				// little endian, the low bytes of the value are the enum.
+				std::memcpy(dst, &item.value, column.size);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	inline parse_func select(const Type* type, size_t size)
+	{
+		if (type == GetType<std::string>())
+		{
+			return &parse_string;
+		}
+		if (type == GetType<bool>())
+		{
+			return &parse_bool;
+		}
+		if (type->GetKind() == Type::Kind::Enum)
+		{
+			return &parse_enum;
+		}
+		if (type->GetKind() != Type::Kind::Numeric)
+		{
+			return nullptr;
+		}
+
+		auto numeric = type->AsNumeric();
+		switch (numeric->GetKind())
+		{
+		case Numeric::Kind::Float:
+			return &parse_number<float>;
+		case Numeric::Kind::Double:
+			return &parse_number<double>;
+		default:
+			break;
+		}
+
+		bool isSigned = numeric->isSigned();
+		switch (size)
+		{
+		case 1:
+			return isSigned ? &parse_number<int8_t> : &parse_number<uint8_t>;
+		case 2:
+			return isSigned ? &parse_number<int16_t> : &parse_number<uint16_t>;
+		case 4:
+			return isSigned ? &parse_number<int32_t> : &parse_number<uint32_t>;
+		case 8:
+			return isSigned ? &parse_number<int64_t> : &parse_number<uint64_t>;
+		}
+		return nullptr;
+	}
+
+	struct Result
+	{
+		size_t rows = 0;
+		size_t errors = 0;
+	};
+
+	namespace detail {
+
+		inline std::string_view next_field(std::string_view& line, char sep)
+		{
+			size_t pos = line.find(sep);
+			std::string_view field = line.substr(0, pos);
+			line = pos == std::string_view::npos ? std::string_view() : line.substr(pos + 1);
+			return field;
+		}
+
+		inline std::string_view next_line(std::string_view& text)
+		{
+			size_t pos = text.find('\n');
+			std::string_view line = text.substr(0, pos);
+			text = pos == std::string_view::npos ? std::string_view() : text.substr(pos + 1);
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.remove_suffix(1);
+			}
+			return line;
+		}
+
+		inline size_t count_lines(std::string_view text)
+		{
+			size_t count = static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+			return count + (!text.empty() && text.back() != '\n' ? 1 : 0);
+		}
+	}
+
+	// Unknown header names are skipped, members without a column keep T{}.
+	template<typename T>
+	Result Import(std::string_view text, std::vector<T>& out, char sep = ',', ThreadPool& pool = ThreadPool::Instance())
+	{
+		Result result;
+		std::string_view header = detail::next_line(text);
+
+		std::vector<Column> columns;
+		while (!header.empty())
+		{
+			std::string_view name = detail::next_field(header, sep);
+			Column column;
+			if (auto var = GetStaticType<T>().GetVariable().Find(name))
+			{
+				column = Column{ select(var->type(), var->size), var->offset, var->size, var->type()->AsEnum() };
+			}
+			columns.push_back(column);
+		}
+
+		// newline aligned chunks, a few per worker to balance uneven lines.
+		size_t chunkCount = std::max<size_t>(1, std::min(text.size() / (1 << 16) + 1, pool.Size() * 4));
+		std::vector<std::string_view> chunks;
+		for (size_t i = 0, begin = 0; i < chunkCount && begin < text.size(); i++)
+		{
+			size_t end = i + 1 == chunkCount ? text.size() : std::max(begin, text.size() * (i + 1) / chunkCount);
+			end = end >= text.size() ? text.size() : std::min(text.size(), text.find('\n', end) + 1);
+			if (end == 0)
+			{
+				end = text.size();
+			}
+			chunks.push_back(text.substr(begin, end - begin));
+			begin = end;
+		}
+
+		std::vector<size_t> firstRow(chunks.size() + 1);
+		pool.ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				firstRow[i + 1] = detail::count_lines(chunks[i]);
+			}
+		});
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			firstRow[i + 1] += firstRow[i];
+		}
+
+		size_t base = out.size();
+		out.resize(base + firstRow.back());
+
+		std::atomic<size_t> errors{ 0 };
+		pool.ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end)
+		{
+			// enum columns read the item list of the current version.
+			epoch::Guard guard;
+			for (size_t i = begin; i < end; i++)
+			{
+				std::string_view chunk = chunks[i];
+				size_t localErrors = 0;
+				for (size_t row = base + firstRow[i]; !chunk.empty(); row++)
+				{
+					std::string_view line = detail::next_line(chunk);
+					char* dst = reinterpret_cast<char*>(&out[row]);
+					for (auto& column : columns)
+					{
+						std::string_view field = detail::next_field(line, sep);
+						if (column.parse && !column.parse(field, dst + column.offset, column))
+						{
+							localErrors++;
+						}
+					}
+				}
+				errors.fetch_add(localErrors, std::memory_order_relaxed);
+			}
+		});
+
+		result.rows = firstRow.back();
+		result.errors = errors.load();
+		return result;
+	}
+}
+
+template<typename T>
+bool Dispatch(T* obj, uint32_t methodId, const void* argBuffer)
+{
+	return GetType<T>()->AsClass()->Dispatch(obj, methodId, argBuffer);
+}
+
+struct Message
+{
+	static constexpr size_t ArgCapacity = Class::MaxDispatchArgBytes;
+
+	const Class* info = nullptr;
+	void* obj = nullptr;
+	uint32_t methodId = Class::InvalidMethod;
+	alignas(std::max_align_t) unsigned char args[ArgCapacity];
+};
+
+// Pack args for method into message.args, checked by the compiler: Args must
+// be the decayed parameter types of method, in order, and fit the buffer.
+// info and methodId are the caller's, the id must name method.
+template<typename Ptr, typename ...Args, typename = std::enable_if_t<std::is_member_function_pointer_v<Ptr>>>
+void PackArgs(Message& message, Ptr method, const Args&... args)
+{
+	using traits = function_traits<Ptr>;
+	using params = typename detail::decay_tuple<typename traits::args>::type;
+	static_assert(std::is_same_v<params, std::tuple<Args...>>, "arguments do not match the method's parameters");
+	static_assert(packed_size<Args...> <= Message::ArgCapacity, "arguments do not fit Message::args");
+	(void)method;
+
+	assert(message.info == GetType<typename traits::class_type>());
+	detail::pack_args(message.args, args...);
+}
+
+// Pack args into message.args for message.methodId of message.info, checked at
+// run time against the registered parameter types. false, and message.args
+// untouched, if the class, the id, the arity or a type does not match.
+template<typename ...Args>
+bool PackArgs(Message& message, const Args&... args)
+{
+	static_assert(packed_size<Args...> <= Message::ArgCapacity, "arguments do not fit Message::args");
+
+	if (!message.info)
+	{
+		return false;
+	}
+
+	epoch::Guard guard;
+	auto& funcs = message.info->GetFunctions();
+	if (message.methodId >= funcs.size())
+	{
+		return false;
+	}
+
+	const Type* types[] = { GetType<Args>()..., nullptr };
+	auto& paramType = funcs[message.methodId].paramType;
+	if (paramType.size() != sizeof...(Args) || !std::equal(paramType.begin(), paramType.end(), types))
+	{
+		return false;
+	}
+
+	detail::pack_args(message.args, args...);
+	return true;
+}
+
+// Consumer threads draining a lock free queue of messages into Class::Dispatch.
+class MessagePump final
+{
+public:
+	MessagePump(size_t consumers, size_t capacity = 1 << 16) : queue_(capacity)
+	{
+		for (size_t i = 0; i < consumers; i++)
+		{
+			consumers_.emplace_back([this] { run(); });
+		}
+	}
+
+	~MessagePump()
+	{
+		stop_.store(true, std::memory_order_release);
+		for (auto& consumer : consumers_)
+		{
+			consumer.join();
+		}
+	}
+
+	bool Post(const Message& message)
+	{
+		return queue_.try_push(message);
+	}
+
+	uint64_t Processed() const { return processed_.load(std::memory_order_relaxed); }
+	uint64_t Rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+private:
+	mpmc_queue<Message> queue_;
+	std::vector<std::thread> consumers_;
+	std::atomic<bool> stop_{ false };
+	std::atomic<uint64_t> processed_{ 0 };
+	std::atomic<uint64_t> rejected_{ 0 };
+
+	// stops once asked to and the queue is empty.
+	void run()
+	{
+		Message message;
+		for (;;)
+		{
+			if (queue_.try_pop(message))
+			{
+				if (message.info && message.info->Dispatch(message.obj, message.methodId, message.args))
+				{
+					processed_.fetch_add(1, std::memory_order_relaxed);
+				}
+				else
+				{
+					rejected_.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			else if (stop_.load(std::memory_order_acquire))
+			{
+				return;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+};
+
+template<typename Ptr>
+MemberVariable MemberVariable::Create(Ptr ptr, std::string_view name)
+{
+	using clazz = typename variable_traits<Ptr>::class_type;
+	using type = typename variable_traits<Ptr>::type;
+
+	MemberVariable var;
+	var.name = name;
+	var.type = GetType<type>();
+	var.size = sizeof(type);
+	var.setter_ = BoundInvoker::Create(ptr, [](const BoundInvoker& self, void* instance, const void* const* columns, size_t row)
+	{
+		static_cast<clazz*>(instance)->*self.Get<Ptr>() = static_cast<const type*>(columns[0])[row];
+	});
+	var.getter_ = [](const BoundInvoker& self, const any& instance)
+	{
+		assert(instance.typeInfo_ == GetType<clazz>());
+		return make_copy(static_cast<const clazz*>(instance.payload_)->*self.Get<Ptr>());
+	};
+	var.address_ = [](const BoundInvoker& self, void* instance)
+	{
+		return const_cast<void*>(static_cast<const void*>(&(static_cast<clazz*>(instance)->*self.Get<Ptr>())));
+	};
+	var.layout_ = &packed_layout<type>;
+	return var;
+}
+
+template<typename Ptr>
+MemberFunction MemberFunction::Create(Ptr ptr, std::string_view name)
+{
+	using traits = function_traits<Ptr>;
+	using args = typename traits::args;
+	using index = std::make_index_sequence<std::tuple_size_v<args>>;
+
+	MemberFunction func;
+	func.name = name;
+	func.retType = GetType<typename traits::return_type>();
+	func.paramType = ConvertTypeList2Vector<args>(index());
+	func.invoker_ = BoundInvoker::Create(ptr, [](const BoundInvoker& self, void* instance, const void* const* columns, size_t row)
+	{
+		bound_call(instance, self.Get<Ptr>(), columns, row, index());
+	});
+	func.caller_ = [](const BoundInvoker& self, const std::vector<any>& anies)
+	{
+		return inner_call(self.Get<Ptr>(), anies, index());
+	};
+	func.layout_ = &tuple_layout<args>::Get;
+	return func;
+}
+
+template<typename Params, size_t ...Idx>
+static_reflect::basic_table<const Type*> MemberFunction::ConvertTypeList2Vector(std::index_sequence<Idx...>)
+{
+	// one extra entry, a method without parameters still gets an array.
+	static const Type* const types[] = { GetType<std::tuple_element_t<Idx, Params>>() ..., nullptr };
+	return { types, sizeof...(Idx) };
+}
+
+template<typename T>
+T* try_cast(any& elem)
+{
+	if (elem.typeInfo_ == GetType<T>())
+	{
+		elem.detach();
+		return (T*)(elem.payload_);
+	}
+	else
+	{
+		return nullptr;
+	}
+}
+
+// read only access, never duplicates a shared payload.
+template<typename T>
+const T* try_cast(const any& elem)
+{
+	if (elem.typeInfo_ == GetType<T>())
+	{
+		return (const T*)(elem.payload_);
+	}
+	else
+	{
+		return nullptr;
+	}
+}
+
+// heap box for a payload, taken from the current arena when T can skip release.
+// only heap boxes are accounted, arena payloads go away with the arena.
+template<typename T, typename ...Args>
+T* new_payload(any::storage_type mode, Args&&... args)
+{
+	if constexpr (std::is_trivially_destructible_v<T>)
+	{
+		if (auto arena = payload::Arena::Current())
+		{
+			return arena->New<T>(std::forward<Args>(args)...);
+		}
+	}
+	memstats::TrackPayload<T>(size_t(mode), 1);
+	return payload::New<T>(std::forward<Args>(args)...);
+}
+
+template<typename T>
+void delete_payload(any::storage_type mode, T* ptr)
+{
+	memstats::TrackPayload<T>(size_t(mode), -1);
+	payload::Delete(ptr);
+}
+
+// payload of a Shared any, value comes first so payload_ points at the box.
+template<typename T>
+struct shared_box
+{
+	T value;
+	std::atomic<uint32_t> refs{ 1 };
+
+	static shared_box* From(void* payload) { return reinterpret_cast<shared_box*>(payload); }
+
+	template<typename ...Args>
+	static shared_box* Create(Args&&... args)
+	{
+		memstats::TrackPayload<T>(size_t(any::storage_type::Shared), 1, sizeof(shared_box));
+		return payload::New<shared_box>(std::forward<Args>(args)...);
+	}
+
+	// drops one owner, the last one frees the box.
+	static void Release(shared_box* box)
+	{
+		if (box->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			memstats::TrackPayload<T>(size_t(any::storage_type::Shared), -1, sizeof(shared_box));
+			payload::Delete(box);
+		}
+	}
+};
+
+template<typename T>
+struct operations_traits
+{
+	static any copy(const any& elem)
+	{
+		assert(elem.typeInfo_ == GetType<T>());
+
+		any return_value;
+
+		return_value.payload_   = new_payload<T>(any::storage_type::Copy, *static_cast<T*>(elem.payload_));
+		return_value.typeInfo_  = elem.typeInfo_;
+		return_value.store_type = any::storage_type::Copy;
+		return_value.ops        = elem.ops;
+		return_value.ops.release = payload::InArena<T>() ? nullptr : &release;
+
+		return return_value;
+	}
+
+	// a copy of a Shared any, one atomic increment and no allocation.
+	static any share(const any& elem)
+	{
+		assert(elem.typeInfo_ == GetType<T>());
+		assert(elem.store_type == any::storage_type::Shared);
+
+		shared_box<T>::From(elem.payload_)->refs.fetch_add(1, std::memory_order_relaxed);
+
+		any return_value;
+
+		return_value.payload_   = elem.payload_;
+		return_value.typeInfo_  = elem.typeInfo_;
+		return_value.store_type = any::storage_type::Shared;
+		return_value.ops        = elem.ops;
+
+		return return_value;
+	}
+
+	static any steal(any& elem)
+	{
+		assert(elem.typeInfo_ == GetType<T>());
+
+		// other owners may still read it, share instead of moving out.
+		if (elem.store_type == any::storage_type::Shared)
+		{
+			return share(elem);
+		}
+
+		any return_value;
+
+		return_value.payload_   = new_payload<T>(any::storage_type::Copy, std::move(*static_cast<T*>(elem.payload_)));
+		return_value.typeInfo_  = elem.typeInfo_;
+		return_value.store_type = any::storage_type::Copy;
+		if (elem.store_type == any::storage_type::Copy && elem.ops.release)
+		{
+			memstats::TrackPayload<T>(size_t(any::storage_type::Copy), -1);
+			memstats::TrackPayload<T>(size_t(any::storage_type::Steal), 1);
+		}
+		elem.store_type         = any::storage_type::Steal;
+		return_value.ops        = elem.ops;
+		return_value.ops.release = payload::InArena<T>() ? nullptr : &release;
+
+		return return_value;
+	}
+
+	static void release(any& elem)
+	{
+		assert(elem.typeInfo_ == GetType<T>());
+
+		if (elem.store_type == any::storage_type::Shared)
+		{
+			shared_box<T>::Release(shared_box<T>::From(elem.payload_));
+		}
+		else
+		{
+			delete_payload(elem.store_type, static_cast<T*>(elem.payload_));
+		}
+		elem.payload_           = nullptr;
+		elem.store_type         = any::storage_type::Empty;
+		elem.typeInfo_          = nullptr;
+	}
+
+	// copy on write, only pays for the copy while someone else holds the payload.
+	static void unshare(any& elem)
+	{
+		assert(elem.store_type == any::storage_type::Shared);
+
+		auto box = shared_box<T>::From(elem.payload_);
+		if (box->refs.load(std::memory_order_acquire) == 1)
+		{
+			return;
+		}
+
+		if constexpr (std::is_copy_constructible_v<T>)
+		{
+			elem.payload_ = shared_box<T>::Create(box->value);
+			shared_box<T>::Release(box);
+		}
+		else
+		{
+			assert(false && "shared payload is not copyable");
+		}
+	}
+};
+
+template<typename T>
+any make_copy(const T& elem)
+{
+	any return_value;
+	return_value.payload_    = new_payload<T>(any::storage_type::Copy, elem);
+	return_value.typeInfo_   = GetType<T>();
+	return_value.store_type  = any::storage_type::Copy;
+
+	if constexpr(std::is_copy_constructible_v<T>)
+	{
+		return_value.ops.copy    = &operations_traits<T>::copy;
+	}
+
+	if constexpr (std::is_move_constructible_v<T>)
+	{
+		return_value.ops.steal   = &operations_traits<T>::steal;
+	}
+
+	// arena payloads are dropped with the arena, never one by one.
+	if constexpr (std::is_destructible_v<T>)
+	{
+		return_value.ops.release = payload::InArena<T>() ? nullptr : &operations_traits<T>::release;
+	}
+
+	return return_value;
+}
+
+template<typename T>
+any make_steal(T&& elem)
+{
+	any return_value;
+	return_value.payload_    = new_payload<T>(any::storage_type::Steal, std::move(elem));
+	return_value.typeInfo_   = GetType<T>();
+	return_value.store_type  = any::storage_type::Steal;
+
+	if constexpr(std::is_copy_constructible_v<T>)
+	{
+		return_value.ops.copy    = &operations_traits<T>::copy;
+	}
+
+	if constexpr (std::is_move_constructible_v<T>)
+	{
+		return_value.ops.steal   = &operations_traits<T>::steal;
+	}
+
+	// arena payloads are dropped with the arena, never one by one.
+	if constexpr (std::is_destructible_v<T>)
+	{
+		return_value.ops.release = payload::InArena<T>() ? nullptr : &operations_traits<T>::release;
+	}
+
+	return return_value;
+}
+
+template<typename T>
+any make_ref(T& elem)
+{
+	any return_value;
+	return_value.payload_    = &elem;
+	return_value.typeInfo_   = GetType<T>();
+	return_value.store_type  = any::storage_type::Ref;
+
+	if constexpr(std::is_copy_constructible_v<T>)
+	{
+		return_value.ops.copy    = &operations_traits<T>::copy;
+	}
+
+	if constexpr (std::is_move_constructible_v<T>)
+	{
+		return_value.ops.steal   = &operations_traits<T>::steal;
+	}
+
+	if constexpr (std::is_destructible_v<T>)
+	{
+		return_value.ops.release = &operations_traits<T>::release;
+	}
+
+	return return_value;
+}
+
+template<typename T>
+any make_cref(const T& elem)
+{
+	any return_value;
+	return_value.payload_    = const_cast<T*>(&elem);
+	return_value.typeInfo_   = GetType<T>();
+	return_value.store_type  = any::storage_type::ConstRef;
+
+	if constexpr(std::is_copy_constructible_v<T>)
+	{
+		return_value.ops.copy    = &operations_traits<T>::copy;
+	}
+
+	if constexpr (std::is_move_constructible_v<T>)
+	{
+		return_value.ops.steal   = &operations_traits<T>::steal;
+	}
+
+	if constexpr (std::is_destructible_v<T>)
+	{
+		return_value.ops.release = &operations_traits<T>::release;
+	}
+
+	return return_value;
+}
+
+template<typename T>
+any make_share(T&& elem)
+{
+	using type = std::remove_cv_t<std::remove_reference_t<T>>;
+
+	any return_value;
+	return_value.payload_    = shared_box<type>::Create(std::forward<T>(elem));
+	return_value.typeInfo_   = GetType<type>();
+	return_value.store_type  = any::storage_type::Shared;
+
+	// copies only bump the count, so copy works for every type.
+	return_value.ops.copy    = &operations_traits<type>::share;
+	return_value.ops.steal   = &operations_traits<type>::steal;
+	return_value.ops.release = &operations_traits<type>::release;
+	return_value.ops.unshare = &operations_traits<type>::unshare;
+
+	return return_value;
+}
+
@@ -0,0 +1,506 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "epoch.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary snapshot of the type registry.
+// Every reference inside the file is an offset from the start of the file, so
+// it can be mapped at any address and queried in place: no parsing, no
+// allocation. Classes and enums are sorted by name for binary search.
+// Opening checks every offset, count and string once, queries trust them.
+
+namespace snapshot {
+
+	constexpr char Magic[4] = { 'R', 'F', 'L', 'S' };
+	// 2 added MemberRecord::numeric, 3 sets NumericSigned for signed enums too.
+	// older files are rejected.
+	constexpr uint32_t Version = 3;
+
+	struct StrRef
+	{
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t fileSize;
+		uint32_t classCount;
+		uint32_t classOffset;
+		uint32_t memberOffset;
+		uint32_t enumCount;
+		uint32_t enumOffset;
+		uint32_t itemOffset;
+		uint32_t stringOffset;
+	};
+
+	struct ClassRecord
+	{
+		StrRef name;
+		uint32_t size;
+		uint32_t align;
+		uint32_t firstMember;
+		uint32_t memberCount;
+	};
+
+	struct MemberRecord
+	{
+		StrRef name;
+		StrRef typeName;
+		uint32_t kind;
+		uint32_t numeric;
+		uint32_t offset;
+		uint32_t size;
+		uint32_t align;
+	};
+
+	// MemberRecord::numeric, Numeric::Kind in the low byte (0 for enums), and
+	// NumericSigned for signed numerics and enums with a signed underlying type.
+	constexpr uint32_t NumericSigned = 0x100;
+
+	struct EnumRecord
+	{
+		StrRef name;
+		uint32_t firstItem;
+		uint32_t itemCount;
+	};
+
+	struct ItemRecord
+	{
+		StrRef name;
+		uint64_t value;
+	};
+
+	// read side, thin views over the mapped bytes.
+
+	template<typename T>
+	struct Range
+	{
+		const T* first;
+		const T* last;
+
+		const T* begin() const { return first; }
+		const T* end() const { return last; }
+		size_t size() const { return last - first; }
+		const T& operator[](size_t idx) const { return first[idx]; }
+	};
+
+	class View
+	{
+	public:
+		View() = default;
+		View(const void* data, size_t size) : data_(static_cast<const char*>(data)), size_(size) {}
+
+		bool IsValid() const { return Error().empty(); }
+
+		// why the bytes are not a snapshot this reader can query, empty if they are.
+		std::string_view Error() const
+		{
+			if (!data_ || size_ < sizeof(Header))
+			{
+				return "too small for a snapshot header";
+			}
+			if (reinterpret_cast<uintptr_t>(data_) % alignof(uint64_t) != 0)
+			{
+				return "snapshot data is not 8 byte aligned";
+			}
+
+			auto& header = GetHeader();
+			if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+			{
+				return "not a snapshot file";
+			}
+			if (header.version == 1)
+			{
+				return "snapshot version 1 has no numeric kinds, write it again with this Writer";
+			}
+			if (header.version == 2)
+			{
+				return "snapshot version 2 has no enum signedness, write it again with this Writer";
+			}
+			if (header.version != Version)
+			{
+				return "unsupported snapshot version";
+			}
+			if (header.fileSize < sizeof(Header) || header.fileSize > size_)
+			{
+				return "file size does not match the header";
+			}
+			if (header.stringOffset > header.fileSize)
+			{
+				return "string table outside the file";
+			}
+			if (!fits<ClassRecord>(header.classOffset, header.classCount) || !fits<EnumRecord>(header.enumOffset, header.enumCount))
+			{
+				return "class or enum table outside the file";
+			}
+
+			// member and item tables carry no count, each record's slice is checked.
+			auto classes = GetClasses();
+			for (size_t i = 0; i < classes.size(); i++)
+			{
+				auto& info = classes[i];
+				if (!string_fits(info.name) || (i > 0 && GetString(classes[i - 1].name) > GetString(info.name)))
+				{
+					return "bad or unsorted class name";
+				}
+				if (!fits<MemberRecord>(header.memberOffset, uint64_t(info.firstMember) + info.memberCount))
+				{
+					return "class members outside the file";
+				}
+				for (auto& member : GetVariable(info))
+				{
+					if (!string_fits(member.name) || !string_fits(member.typeName))
+					{
+						return "bad member name";
+					}
+				}
+			}
+
+			auto enums = GetEnums();
+			for (size_t i = 0; i < enums.size(); i++)
+			{
+				auto& info = enums[i];
+				if (!string_fits(info.name) || (i > 0 && GetString(enums[i - 1].name) > GetString(info.name)))
+				{
+					return "bad or unsorted enum name";
+				}
+				if (!fits<ItemRecord>(header.itemOffset, uint64_t(info.firstItem) + info.itemCount))
+				{
+					return "enum items outside the file";
+				}
+				for (auto& item : GetItems(info))
+				{
+					if (!string_fits(item.name))
+					{
+						return "bad item name";
+					}
+				}
+			}
+			return {};
+		}
+
+		const Header& GetHeader() const { return *reinterpret_cast<const Header*>(data_); }
+
+		std::string_view GetString(StrRef ref) const
+		{
+			return std::string_view(data_ + GetHeader().stringOffset + ref.offset, ref.length);
+		}
+
+		Range<ClassRecord> GetClasses() const { return range<ClassRecord>(GetHeader().classOffset, GetHeader().classCount); }
+		Range<EnumRecord> GetEnums() const { return range<EnumRecord>(GetHeader().enumOffset, GetHeader().enumCount); }
+
+		Range<MemberRecord> GetVariable(const ClassRecord& info) const
+		{
+			auto first = reinterpret_cast<const MemberRecord*>(data_ + GetHeader().memberOffset) + info.firstMember;
+			return { first, first + info.memberCount };
+		}
+
+		Range<ItemRecord> GetItems(const EnumRecord& info) const
+		{
+			auto first = reinterpret_cast<const ItemRecord*>(data_ + GetHeader().itemOffset) + info.firstItem;
+			return { first, first + info.itemCount };
+		}
+
+		const ClassRecord* FindClass(std::string_view name) const { return find(GetClasses(), name); }
+		const EnumRecord* FindEnum(std::string_view name) const { return find(GetEnums(), name); }
+
+		const MemberRecord* FindVariable(const ClassRecord& info, std::string_view name) const
+		{
+			for (auto& member : GetVariable(info))
+			{
+				if (GetString(member.name) == name)
+				{
+					return &member;
+				}
+			}
+			return nullptr;
+		}
+
+	private:
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+
+		// count records of T at offset lie inside the file, aligned.
+		template<typename T>
+		bool fits(uint32_t offset, uint64_t count) const
+		{
+			return offset % alignof(T) == 0 && offset >= sizeof(Header) && offset + count * sizeof(T) <= GetHeader().fileSize;
+		}
+
+		bool string_fits(StrRef ref) const
+		{
+			return uint64_t(GetHeader().stringOffset) + ref.offset + ref.length <= GetHeader().fileSize;
+		}
+
+		template<typename T>
+		Range<T> range(uint32_t offset, uint32_t count) const
+		{
+			auto first = reinterpret_cast<const T*>(data_ + offset);
+			return { first, first + count };
+		}
+
+		template<typename T>
+		const T* find(Range<T> records, std::string_view name) const
+		{
+			auto it = std::lower_bound(records.begin(), records.end(), name, [&](const T& record, std::string_view key) { return GetString(record.name) < key; });
+			return it != records.end() && GetString(it->name) == name ? it : nullptr;
+		}
+	};
+
+	// read only mapping of a snapshot file.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile()
+		{
+			Close();
+		}
+
+		bool Open(const std::string& path)
+		{
+			Close();
+#ifdef _WIN32
+			file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file_ == INVALID_HANDLE_VALUE)
+			{
+				error_ = "cannot open the file";
+				return false;
+			}
+			LARGE_INTEGER size;
+			GetFileSizeEx(file_, &size);
+			size_ = static_cast<size_t>(size.QuadPart);
+			mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			data_ = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				error_ = "cannot open the file";
+				return false;
+			}
+			struct stat st;
+			if (fstat(fd, &st) == 0 && st.st_size > 0)
+			{
+				size_ = static_cast<size_t>(st.st_size);
+				data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+				data_ = data_ == MAP_FAILED ? nullptr : data_;
+			}
+			::close(fd);
+#endif
+			error_ = data_ ? GetView().Error() : std::string_view("cannot map the file");
+			if (!error_.empty())
+			{
+				Close();
+				return false;
+			}
+			return true;
+		}
+
+		// why the last Open failed.
+		std::string_view Error() const { return error_; }
+
+		void Close()
+		{
+#ifdef _WIN32
+			if (data_) UnmapViewOfFile(data_);
+			if (mapping_) CloseHandle(mapping_);
+			if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+			mapping_ = nullptr;
+			file_ = INVALID_HANDLE_VALUE;
+#else
+			if (data_) munmap(data_, size_);
+#endif
+			data_ = nullptr;
+			size_ = 0;
+		}
+
+		View GetView() const { return View(data_, size_); }
+
+	private:
+		void* data_ = nullptr;
+		size_t size_ = 0;
+		std::string_view error_;
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#endif
+	};
+
+	// write side, collects static tables and lays out the file.
+	class Writer
+	{
+	public:
+		// Info is a static_reflect::Class, members resolve their Type for name and kind.
+		template<typename Info>
+		Writer& AddClass(const Info& info)
+		{
+			epoch::Guard guard;
+			PendingClass pending{ std::string(info.name), uint32_t(info.size), uint32_t(info.align), {} };
+			for (auto& var : info.GetVariable())
+			{
+				auto type = var.type();
+				auto numeric = type->AsNumeric();
+				auto enumInfo = type->AsEnum();
+				uint32_t code = numeric ? uint32_t(numeric->GetKind()) | (numeric->isSigned() ? NumericSigned : 0) : 0;
+				code |= enumInfo && enumInfo->isSigned() ? NumericSigned : 0;
+				pending.members.push_back(PendingMember{ std::string(var.name), type->GetName(), uint32_t(type->GetKind()), code, uint32_t(var.offset), uint32_t(var.size), uint32_t(var.align) });
+			}
+			classes_.push_back(std::move(pending));
+			return *this;
+		}
+
+		// Info is a static_reflect::Enum.
+		template<typename Info>
+		Writer& AddEnum(const Info& info)
+		{
+			PendingEnum pending{ std::string(info.name), {} };
+			for (auto& item : info.GetItems())
+			{
+				pending.items.push_back(PendingItem{ std::string(item.name), uint64_t(item.value) });
+			}
+			enums_.push_back(std::move(pending));
+			return *this;
+		}
+
+		std::vector<char> Build() const
+		{
+			auto classes = classes_;
+			auto enums = enums_;
+			std::stable_sort(classes.begin(), classes.end(), [](auto& a, auto& b) { return a.name < b.name; });
+			std::stable_sort(enums.begin(), enums.end(), [](auto& a, auto& b) { return a.name < b.name; });
+
+			std::string strings;
+			auto intern = [&](const std::string& str)
+			{
+				StrRef ref{ uint32_t(strings.size()), uint32_t(str.size()) };
+				strings += str;
+				return ref;
+			};
+
+			std::vector<ClassRecord> classRecords;
+			std::vector<MemberRecord> memberRecords;
+			for (auto& info : classes)
+			{
+				classRecords.push_back(ClassRecord{ intern(info.name), info.size, info.align, uint32_t(memberRecords.size()), uint32_t(info.members.size()) });
+				for (auto& member : info.members)
+				{
+					memberRecords.push_back(MemberRecord{ intern(member.name), intern(member.typeName), member.kind, member.numeric, member.offset, member.size, member.align });
+				}
+			}
+
+			std::vector<EnumRecord> enumRecords;
+			std::vector<ItemRecord> itemRecords;
+			for (auto& info : enums)
+			{
+				enumRecords.push_back(EnumRecord{ intern(info.name), uint32_t(itemRecords.size()), uint32_t(info.items.size()) });
+				for (auto& item : info.items)
+				{
+					itemRecords.push_back(ItemRecord{ intern(item.name), item.value });
+				}
+			}
+
+			Header header{};
+			std::memcpy(header.magic, Magic, sizeof(Magic));
+			header.version = Version;
+			header.classCount = uint32_t(classRecords.size());
+			header.enumCount = uint32_t(enumRecords.size());
+
+			std::vector<char> file(sizeof(Header));
+			header.classOffset = append(file, classRecords);
+			header.memberOffset = append(file, memberRecords);
+			header.enumOffset = append(file, enumRecords);
+			header.itemOffset = append(file, itemRecords);
+			header.stringOffset = uint32_t(file.size());
+			file.insert(file.end(), strings.begin(), strings.end());
+			header.fileSize = uint32_t(file.size());
+
+			std::memcpy(file.data(), &header, sizeof(Header));
+			return file;
+		}
+
+		bool Save(const std::string& path) const
+		{
+			auto file = Build();
+			FILE* fp = std::fopen(path.c_str(), "wb");
+			if (!fp)
+			{
+				return false;
+			}
+			bool ok = std::fwrite(file.data(), 1, file.size(), fp) == file.size();
+			return std::fclose(fp) == 0 && ok;
+		}
+
+	private:
+		struct PendingMember
+		{
+			std::string name;
+			std::string typeName;
+			uint32_t kind;
+			uint32_t numeric;
+			uint32_t offset;
+			uint32_t size;
+			uint32_t align;
+		};
+
+		struct PendingClass
+		{
+			std::string name;
+			uint32_t size;
+			uint32_t align;
+			std::vector<PendingMember> members;
+		};
+
+		struct PendingItem
+		{
+			std::string name;
+			uint64_t value;
+		};
+
+		struct PendingEnum
+		{
+			std::string name;
+			std::vector<PendingItem> items;
+		};
+
+		std::vector<PendingClass> classes_;
+		std::vector<PendingEnum> enums_;
+
+		// records are 8 byte aligned inside the file.
+		template<typename T>
+		static uint32_t append(std::vector<char>& file, const std::vector<T>& records)
+		{
+			file.resize((file.size() + 7) / 8 * 8);
+			uint32_t offset = uint32_t(file.size());
+			const char* bytes = reinterpret_cast<const char*>(records.data());
+			file.insert(file.end(), bytes, bytes + records.size() * sizeof(T));
+			return offset;
+		}
+	};
+}
@@ -0,0 +1,321 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "variable_traits.h"
+
+template<typename T>
+struct TypeInfo;
+
+// contiguous view over one column.
+
+template<typename T>
+struct column_view
+{
+	T* data_;
+	size_t size_;
+
+	T* data() const { return data_; }
+	size_t size() const { return size_; }
+	T* begin() const { return data_; }
+	T* end() const { return data_ + size_; }
+	T& operator[](size_t idx) const { return data_[idx]; }
+};
+
+// growable contiguous storage for one column.
+// std::vector is not used because std::vector<bool> has no contiguous data().
+
+template<typename T>
+class soa_column
+{
+public:
+	soa_column() = default;
+	soa_column(soa_column&&) = default;
+	soa_column& operator=(soa_column&&) = default;
+
+	soa_column(const soa_column& o) { append(o.data_.get(), o.size_); }
+	soa_column& operator=(const soa_column& o)
+	{
+		clear();
+		append(o.data_.get(), o.size_);
+		return *this;
+	}
+
+	T* data() { return data_.get(); }
+	const T* data() const { return data_.get(); }
+	size_t size() const { return size_; }
+	size_t capacity() const { return capacity_; }
+	T& operator[](size_t idx) { return data_[idx]; }
+	const T& operator[](size_t idx) const { return data_[idx]; }
+	T& back() { return data_[size_ - 1]; }
+
+	void reserve(size_t count)
+	{
+		if (count <= capacity_)
+		{
+			return;
+		}
+
+		// value initialized: slots past size_ always hold T{}, resize relies on it.
+		std::unique_ptr<T[]> data(new T[count]());
+		for (size_t i = 0; i < size_; i++)
+		{
+			data[i] = std::move(data_[i]);
+		}
+		data_ = std::move(data);
+		capacity_ = count;
+	}
+
+	// room for count elements, at least doubling so repeated appends stay linear.
+	void grow(size_t count)
+	{
+		if (count > capacity_)
+		{
+			reserve(std::max({ count, capacity_ * 2, size_t(16) }));
+		}
+	}
+
+	void resize(size_t count)
+	{
+		reserve(count);
+		for (size_t i = count; i < size_; i++)
+		{
+			data_[i] = T{};
+		}
+		size_ = count;
+	}
+
+	void clear() { resize(0); }
+
+	void push_back(const T& value)
+	{
+		grow(size_ + 1);
+		data_[size_++] = value;
+	}
+
+	void append(const T* values, size_t count)
+	{
+		grow(size_ + count);
+		for (size_t i = 0; i < count; i++)
+		{
+			data_[size_++] = values[i];
+		}
+	}
+
+	void pop_back() { data_[--size_] = T{}; }
+
+	void erase(size_t first, size_t last)
+	{
+		std::move(data_.get() + last, data_.get() + size_, data_.get() + first);
+		resize(size_ - (last - first));
+	}
+
+private:
+	std::unique_ptr<T[]> data_;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+};
+
+// Structure of arrays container.
+// Every member listed in TypeInfo<T>::variables gets its own column, so a
+// loop over one column only touches that column and can be vectorized. Element
+// access goes through a proxy that reads and writes across all columns.
+
+template<typename T>
+class soa_vector
+{
+public:
+	using value_type = T;
+
+private:
+	using variables_type = std::remove_const_t<decltype(TypeInfo<T>::variables)>;
+
+	static constexpr size_t column_count = std::tuple_size_v<variables_type>;
+
+	template<size_t I>
+	using pointer_type = decltype(std::tuple_element_t<I, variables_type>::pointer);
+
+	template<size_t I>
+	using column_type = typename variable_traits<pointer_type<I>>::type;
+
+	template<size_t I>
+	static constexpr pointer_type<I> pointer() { return std::get<I>(TypeInfo<T>::variables).pointer; }
+
+	template<typename Seq>
+	struct columns_tuple;
+
+	template<size_t ...Idx>
+	struct columns_tuple<std::index_sequence<Idx...>>
+	{
+		using type = std::tuple<soa_column<column_type<Idx>>...>;
+	};
+
+	using columns_type = typename columns_tuple<std::make_index_sequence<column_count>>::type;
+
+	template<auto Ptr, size_t I = 0>
+	static constexpr size_t index_of()
+	{
+		static_assert(I < column_count, "member is not registered in TypeInfo<T>::variables");
+
+		if constexpr (std::is_same_v<decltype(Ptr), pointer_type<I>>)
+		{
+			if constexpr (Ptr == pointer<I>())
+			{
+				return I;
+			}
+			else
+			{
+				return index_of<Ptr, I + 1>();
+			}
+		}
+		else
+		{
+			return index_of<Ptr, I + 1>();
+		}
+	}
+
+	template<auto Key>
+	static constexpr size_t key_index()
+	{
+		if constexpr (std::is_integral_v<decltype(Key)>)
+		{
+			return Key;
+		}
+		else
+		{
+			return index_of<Key>();
+		}
+	}
+
+	template<typename F, size_t ...Idx>
+	void for_each_column(F&& f, std::index_sequence<Idx...>)
+	{
+		(f(std::get<Idx>(columns_), std::integral_constant<size_t, Idx>{}), ...);
+	}
+
+	template<typename F>
+	void for_each_column(F&& f)
+	{
+		for_each_column(std::forward<F>(f), std::make_index_sequence<column_count>());
+	}
+
+public:
+
+	template<bool IsConst>
+	class basic_reference
+	{
+	public:
+		using owner_type = std::conditional_t<IsConst, const soa_vector, soa_vector>;
+
+		basic_reference(owner_type& owner, size_t idx) : owner_(owner), idx_(idx) {}
+
+		template<auto Key>
+		auto& get() const { return std::get<key_index<Key>()>(owner_.columns_)[idx_]; }
+
+		operator T() const
+		{
+			T value{};
+			owner_.load(value, idx_, std::make_index_sequence<column_count>());
+			return value;
+		}
+
+		template<bool C = IsConst, typename = std::enable_if_t<!C>>
+		const basic_reference& operator=(const T& value) const
+		{
+			owner_.store(value, idx_, std::make_index_sequence<column_count>());
+			return *this;
+		}
+
+	private:
+		owner_type& owner_;
+		size_t idx_;
+	};
+
+	using reference = basic_reference<false>;
+	using const_reference = basic_reference<true>;
+
+	size_t size() const { return std::get<0>(columns_).size(); }
+	bool empty() const { return size() == 0; }
+
+	reference operator[](size_t idx) { return reference(*this, idx); }
+	const_reference operator[](size_t idx) const { return const_reference(*this, idx); }
+
+	// Key is either the column index or the member pointer, e.g. column<&Person::height>().
+
+	template<auto Key>
+	column_view<column_type<key_index<Key>()>> column() { return { std::get<key_index<Key>()>(columns_).data(), size() }; }
+
+	template<auto Key>
+	column_view<const column_type<key_index<Key>()>> column() const { return { std::get<key_index<Key>()>(columns_).data(), size() }; }
+
+	void reserve(size_t count)
+	{
+		for_each_column([&](auto& col, auto) { col.reserve(count); });
+	}
+
+	void resize(size_t count)
+	{
+		for_each_column([&](auto& col, auto) { col.resize(count); });
+	}
+
+	void clear()
+	{
+		for_each_column([](auto& col, auto) { col.clear(); });
+	}
+
+	void push_back(const T& value)
+	{
+		append(&value, 1);
+	}
+
+	// bulk push, each column is walked once.
+	void append(const T* values, size_t count)
+	{
+		for_each_column([&](auto& col, auto idx)
+		{
+			constexpr auto ptr = pointer<decltype(idx)::value>();
+			col.grow(col.size() + count);
+			for (size_t i = 0; i < count; i++)
+			{
+				col.push_back(values[i].*ptr);
+			}
+		});
+	}
+
+	// bulk erase of [first, last), each column is walked once.
+	void erase(size_t first, size_t last)
+	{
+		for_each_column([&](auto& col, auto)
+		{
+			col.erase(first, last);
+		});
+	}
+
+	// O(1) erase that moves the last element into idx.
+	void swap_remove(size_t idx)
+	{
+		for_each_column([&](auto& col, auto)
+		{
+			col[idx] = std::move(col.back());
+			col.pop_back();
+		});
+	}
+
+private:
+	columns_type columns_;
+
+	template<size_t ...Idx>
+	void load(T& value, size_t idx, std::index_sequence<Idx...>) const
+	{
+		((value.*pointer<Idx>() = std::get<Idx>(columns_)[idx]), ...);
+	}
+
+	template<size_t ...Idx>
+	void store(const T& value, size_t idx, std::index_sequence<Idx...>)
+	{
+		((std::get<Idx>(columns_)[idx] = value.*pointer<Idx>()), ...);
+	}
+};
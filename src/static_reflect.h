@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+class Type;
+
+template<typename T>
+const Type* GetType();
+
+namespace static_reflect {
+
+	// one member variable, everything is known at compile time.
+
+	struct Variable
+	{
+		std::string_view name;
+		size_t offset;
+		size_t size;
+		size_t align;
+		const Type* (*type)();
+	};
+
+	// one enum item.
+
+	struct Item
+	{
+		using value_type = uint64_t;
+		std::string_view name;
+		value_type value;
+	};
+
+	template<typename T>
+	struct basic_table
+	{
+		const T* data;
+		size_t count;
+
+		constexpr const T* begin() const { return data; }
+		constexpr const T* end() const { return data + count; }
+		constexpr size_t size() const { return count; }
+		constexpr bool empty() const { return count == 0; }
+		constexpr const T& operator[](size_t idx) const { return data[idx]; }
+
+		constexpr const T* Find(std::string_view name) const
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				if (data[i].name == name)
+				{
+					return &data[i];
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	struct Class
+	{
+		std::string_view name;
+		size_t size;
+		size_t align;
+		basic_table<Variable> variables;
+
+		constexpr auto& GetVariable() const { return variables; }
+	};
+
+	struct Enum
+	{
+		std::string_view name;
+		basic_table<Item> items;
+
+		constexpr auto& GetItems() const { return items; }
+	};
+}
+
+template<typename T>
+struct StaticTypeInfo;
+
+// true for types with a static table, an explicit specialization made next to
+// StaticTypeInfo by the macros below; nothing is inferred from whether the
+// table happens to be complete. Put the table in the header that defines the
+// type, so every translation unit sees the same answer. Within one unit, a
+// table declared after the trait was used is a compile error.
+template<typename T>
+struct has_static_type : std::false_type {};
+
+template<typename T>
+constexpr auto& GetStaticType()
+{
+	return StaticTypeInfo<T>::value;
+}
+
+// The tables below are constant-initialized: names are string literals,
+// offsets come from offsetof and the Type getter is a plain function pointer,
+// so nothing runs before main. Runtime ClassFactory registration is still
+// available for types that are only known after loading a plugin.
+
+#define BEGIN_STATIC_CLASS(x) template<> struct has_static_type<x> : std::true_type {}; \
+	template<> struct StaticTypeInfo<x> { using type = x; \
+	static constexpr static_reflect::Variable variables[] = {
+#define static_var(m)          static_reflect::Variable{ #m, offsetof(type, m), sizeof(decltype(type::m)), alignof(decltype(type::m)), &GetType<decltype(type::m)> },
+#define END_STATIC_CLASS(x)    }; \
+	static constexpr static_reflect::Class value{ #x, sizeof(type), alignof(type), { variables, std::size(variables) } }; };
+
+#define BEGIN_STATIC_ENUM(x)  template<> struct has_static_type<x> : std::true_type {}; \
+	template<> struct StaticTypeInfo<x> { using type = x; \
+	static constexpr static_reflect::Item items[] = {
+#define static_item(v)         static_reflect::Item{ #v, static_cast<static_reflect::Item::value_type>(type::v) },
+#define END_STATIC_ENUM(x)     }; \
+	static constexpr static_reflect::Enum value{ #x, { items, std::size(items) } }; };
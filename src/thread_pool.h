@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work stealing thread pool for range jobs.
+// Each worker owns a deque: it pops its own work from the back and steals from
+// the front of the others. Jobs are [begin, end) chunks of one range call, so
+// submitting never allocates per item.
+
+class ThreadPool final
+{
+public:
+	struct Task
+	{
+		void(*fn)(void* ctx, size_t begin, size_t end) = {};
+		void* ctx = {};
+		size_t begin = 0;
+		size_t end = 0;
+		std::atomic<size_t>* remaining = {};
+	};
+
+	explicit ThreadPool(size_t threads = std::thread::hardware_concurrency())
+	{
+		threads = std::max<size_t>(threads, 1);
+		queues_.reserve(threads);
+		for (size_t i = 0; i < threads; i++)
+		{
+			queues_.push_back(std::make_unique<Queue>());
+		}
+		for (size_t i = 0; i < threads; i++)
+		{
+			workers_.emplace_back([this, i] { run(i); });
+		}
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+			stop_ = true;
+		}
+		sleep_.notify_all();
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	static ThreadPool& Instance()
+	{
+		static ThreadPool inst;
+		return inst;
+	}
+
+	size_t Size() const { return workers_.size(); }
+
+	// call f(begin, end) over [0, count) in chunks of grain, the calling thread helps.
+	template<typename F>
+	void ParallelFor(size_t count, size_t grain, F&& f)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		grain = std::max<size_t>(grain, 1);
+		size_t chunks = (count + grain - 1) / grain;
+		std::atomic<size_t> remaining{ chunks };
+
+		auto thunk = [](void* ctx, size_t begin, size_t end) { (*static_cast<std::remove_reference_t<F>*>(ctx))(begin, end); };
+
+		pending_.fetch_add(chunks, std::memory_order_release);
+		for (size_t i = 0; i < chunks; i++)
+		{
+			Task task{ thunk, (void*)&f, i * grain, std::min(count, (i + 1) * grain), &remaining };
+			Queue& queue = *queues_[i % queues_.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(task);
+		}
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+		}
+		sleep_.notify_all();
+
+		size_t victim = 0;
+		while (remaining.load(std::memory_order_acquire) != 0)
+		{
+			Task task;
+			if (steal(victim++ % queues_.size(), task))
+			{
+				execute(task);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::vector<std::thread> workers_;
+	std::atomic<size_t> pending_{ 0 };
+	std::mutex sleepMutex_;
+	std::condition_variable sleep_;
+	bool stop_ = false;
+
+	bool pop(size_t idx, Task& task)
+	{
+		Queue& queue = *queues_[idx];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+		{
+			return false;
+		}
+		task = queue.tasks.back();
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	bool steal(size_t idx, Task& task)
+	{
+		Queue& queue = *queues_[idx];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+		{
+			return false;
+		}
+		task = queue.tasks.front();
+		queue.tasks.pop_front();
+		return true;
+	}
+
+	void execute(const Task& task)
+	{
+		pending_.fetch_sub(1, std::memory_order_relaxed);
+		task.fn(task.ctx, task.begin, task.end);
+		task.remaining->fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void run(size_t idx)
+	{
+		for (;;)
+		{
+			Task task;
+			bool found = pop(idx, task);
+			for (size_t i = 1; !found && i < queues_.size(); i++)
+			{
+				found = steal((idx + i) % queues_.size(), task);
+			}
+
+			if (found)
+			{
+				execute(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex_);
+			sleep_.wait(lock, [this] { return stop_ || pending_.load(std::memory_order_acquire) != 0; });
+			if (stop_)
+			{
+				return;
+			}
+		}
+	}
+};
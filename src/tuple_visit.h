@@ -0,0 +1,87 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Visiting tuple elements by an index or a predicate only known at run time.
+
+namespace detail {
+
+	// one entry of the jump table, calls f on element Idx.
+
+	template<typename Ret, size_t Idx, typename Tuple, typename Function>
+	Ret visit_at(Tuple& tuple, Function& f)
+	{
+		return f(std::get<Idx>(tuple));
+	}
+
+	// table[n] visits the n-th index of the sequence.
+	template<typename Tuple, typename Function, size_t ...Idx>
+	decltype(auto) visit_at(Tuple& tuple, size_t n, Function& f, std::index_sequence<Idx...>)
+	{
+		using return_type = std::common_type_t<decltype(f(std::get<Idx>(tuple)))...>;
+		using function_type = return_type(*)(Tuple&, Function&);
+
+		static constexpr function_type table[] = { &visit_at<return_type, Idx, Tuple, Function>... };
+		assert(n < sizeof...(Idx));
+		return table[n](tuple, f);
+	}
+
+	template<typename Tuple, typename Function, size_t ...Idx>
+	void visit_each(Tuple& tuple, Function& f, std::index_sequence<Idx...>)
+	{
+		(f(std::get<Idx>(tuple)), ...);
+	}
+
+	// indices of the elements whose type satisfies Pred.
+
+	template<typename Tuple, template<typename> typename Pred, typename Seq>
+	struct filter_index;
+
+	template<typename Tuple, template<typename> typename Pred>
+	struct filter_index<Tuple, Pred, std::index_sequence<>>
+	{
+		using type = std::index_sequence<>;
+	};
+
+	template<typename Tuple, template<typename> typename Pred, size_t I, size_t ...Remains>
+	struct filter_index<Tuple, Pred, std::index_sequence<I, Remains...>>
+	{
+		template<size_t ...Idx>
+		static auto prepend(std::index_sequence<Idx...>) -> std::conditional_t<Pred<std::tuple_element_t<I, Tuple>>::value,
+			std::index_sequence<I, Idx...>,
+			std::index_sequence<Idx...>>;
+
+		using type = decltype(prepend(typename filter_index<Tuple, Pred, std::index_sequence<Remains...>>::type{}));
+	};
+}
+
+// call f(std::get<idx>(tuple)) with idx only known at run time.
+// One indirect call through a constexpr table of function pointers instead of
+// a chain of comparisons, the results of f must share a common type.
+template<typename Tuple, typename Function>
+decltype(auto) VisitAt(Tuple& tuple, size_t idx, Function&& f)
+{
+	constexpr size_t size = std::tuple_size_v<std::remove_const_t<Tuple>>;
+	return detail::visit_at(tuple, idx, f, std::make_index_sequence<size>());
+}
+
+// call f on every element whose type satisfies Pred, the rest are dropped at compile time.
+template<template<typename> typename Pred, typename Tuple, typename Function>
+void VisitIf(Tuple& tuple, Function&& f)
+{
+	using tuple_type = std::remove_const_t<Tuple>;
+	using index_type = typename detail::filter_index<tuple_type, Pred, std::make_index_sequence<std::tuple_size_v<tuple_type>>>::type;
+	detail::visit_each(tuple, f, index_type{});
+}
+
+// call f on the n-th element whose type satisfies Pred.
+template<template<typename> typename Pred, typename Tuple, typename Function>
+decltype(auto) VisitAtIf(Tuple& tuple, size_t n, Function&& f)
+{
+	using tuple_type = std::remove_const_t<Tuple>;
+	using index_type = typename detail::filter_index<tuple_type, Pred, std::make_index_sequence<std::tuple_size_v<tuple_type>>>::type;
+	return detail::visit_at(tuple, n, f, index_type{});
+}
@@ -40,4 +40,5 @@ template<typename Class, typename T>
 struct variable_traits<T Class::*> : internal::basic_variable_traits<T Class::*>
 {
 	using pointer_type = T Class::*;
+	using class_type = Class;
 };
\ No newline at end of file
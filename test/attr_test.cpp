@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Unit
+{
+	int32_t hp = 0;
+	int32_t mana = 0;
+	float speed = 0;
+	float scale = 0;
+	int32_t cache = 0;
+};
+
+int main()
+{
+	Registrar<Unit>().Regist("Unit")
+		.AddVariable(&Unit::hp, "hp", attr::replicated | attr::range(0, 100))
+		.AddVariable(&Unit::mana, "mana", attr::replicated)
+		.AddVariable(&Unit::speed, "speed", attr::editor_only | attr::range(0.5, 4))
+		.AddVariable(&Unit::scale, "scale")
+		.AddVariable(&Unit::cache, "cache", attr::transient);
+
+	const Type* type = GetType<Unit>();
+	const Class* info = type->AsClass();
+	auto version = type->GetVersion();
+	{
+		epoch::Guard guard;
+
+		// every combination of the four flags is answered from the frozen lists.
+		CHECK(info->GetVariable(attr::None).size() == 5);
+		CHECK(info->GetVariable(attr::Replicated) == std::vector<uint32_t>({ 0, 1 }));
+		CHECK(info->GetVariable(attr::Ranged) == std::vector<uint32_t>({ 0, 2 }));
+		CHECK(info->GetVariable(attr::Replicated | attr::Ranged) == std::vector<uint32_t>({ 0 }));
+		CHECK(info->GetVariable(attr::Transient) == std::vector<uint32_t>({ 4 }));
+		CHECK(info->GetVariable(attr::Transient | attr::Replicated).empty());
+
+		// bits outside the fixed set are ignored.
+		CHECK(info->GetVariable(attr::Replicated | (1u << 20)) == std::vector<uint32_t>({ 0, 1 }));
+
+		CHECK(info->GetVariableRange(0)->max == 100);
+		CHECK(info->GetVariableRange(2)->min == 0.5);
+		CHECK(info->GetVariableRange(1) == nullptr);
+		CHECK(info->GetMembers()[1].attrs == attr::Replicated);
+	}
+
+	// an Edit batch is one new version however many members it adds.
+	{
+		auto batch = Registrar<Unit>().Edit();
+		batch.AddVariable(&Unit::hp, "hp2", attr::replicated);
+		batch.AddVariable(&Unit::mana, "mana2", attr::replicated);
+		batch.AddVariable(&Unit::speed, "speed2", attr::replicated);
+		CHECK(type->GetVersion() == version);
+
+		// Commit publishes now and frees the factory for the rest of the scope.
+		batch.Commit();
+		CHECK(type->GetVersion() == version + 1);
+		CHECK(info->GetVariable().size() == 8);
+
+		Registrar<Unit>().AddVariable(&Unit::cache, "cache2");
+		CHECK(type->GetVersion() == version + 2);
+	}
+	CHECK(type->GetVersion() == version + 2 && info->GetVariable().size() == 9);
+	{
+		epoch::Guard guard;
+		CHECK(info->GetVariable(attr::Replicated) == std::vector<uint32_t>({ 0, 1, 5, 6, 7 }));
+	}
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Body
+{
+	float mass;
+	double speed;
+	int ticks;
+
+	void Scale(float k, double bias) { speed = speed * k + bias; }
+	int Tick() { return ++ticks; }
+};
+
+int main()
+{
+	Registrar<Body>().Regist("Body")
+		.AddVariable(&Body::mass, "mass")
+		.AddFunction(&Body::Scale, "Scale")
+		.AddFunction(&Body::Tick, "Tick");
+
+	epoch::Guard guard;
+	auto& data = GetType<Body>()->AsClass()->Current();
+	auto& mass = data.GetVariable()[0];
+	auto& scale = data.GetFunctions()[data.FindFunction("Scale")];
+	auto& tick = data.GetFunctions()[data.FindFunction("Tick")];
+
+	constexpr size_t Count = 100003;
+	std::vector<float> masses(Count), factors(Count);
+	std::vector<double> biases(Count);
+	for (size_t i = 0; i < Count; i++)
+	{
+		masses[i] = float(i);
+		factors[i] = float(i % 7);
+		biases[i] = double(i % 3);
+	}
+
+	// every pool size and a grain that does not divide the count give the same rows.
+	for (size_t threads : { 1, 2, 4 })
+	{
+		ThreadPool pool(threads);
+		std::vector<Body> bodies(Count, Body{ 0.0f, 2.0, 0 });
+
+		const void* massColumn[] = { masses.data() };
+		BulkApply(bodies.data(), Count, mass, massColumn, 1000, pool);
+
+		const void* scaleColumns[] = { factors.data(), biases.data() };
+		BulkApply(bodies.data(), Count, scale, scaleColumns, 777, pool);
+
+		BulkApply(bodies.data(), Count, tick, nullptr, 4096, pool);
+		BulkApply(bodies.data(), Count, tick, nullptr, Count * 2, pool);
+
+		for (size_t i = 0; i < Count; i++)
+		{
+			CHECK(bodies[i].mass == float(i));
+			CHECK(bodies[i].speed == 2.0 * float(i % 7) + double(i % 3));
+			CHECK(bodies[i].ticks == 2);
+		}
+
+		// nothing to do is not an error.
+		BulkApply(bodies.data(), 0, tick, nullptr, 4096, pool);
+		CHECK(bodies[0].ticks == 2);
+	}
+	return 0;
+}
@@ -0,0 +1,69 @@
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Counter
+{
+	int total = 0;
+
+	int Add(int value) { return total += value; }
+	int AddScaled(int value, float scale) { return total += int(float(value) * scale); }
+	int Twice(double value) { return total += int(value * 2); }
+	int Twice(int value) { return total += value * 2; }
+};
+
+int main()
+{
+	Registrar<Counter>().Regist("Counter")
+		.AddFunction(&Counter::Add, "Add")
+		.AddFunction(&Counter::AddScaled, "Add")
+		.AddFunction(static_cast<int(Counter::*)(double)>(&Counter::Twice), "Twice")
+		.AddFunction(static_cast<int(Counter::*)(int)>(&Counter::Twice), "Twice");
+
+	Counter counter;
+	CallSite add("Add");
+
+	// the first call of a shape misses, the rest hit.
+	for (int i = 0; i < 10; i++)
+	{
+		add.Call({ make_ref(counter), make_copy(1) });
+	}
+	CHECK(counter.total == 10);
+	CHECK(add.Misses() == 1 && add.Hits() == 9);
+
+	// overloads under one name are told apart by argument types, once per shape.
+	add.Call({ make_ref(counter), make_copy(10), make_copy(0.5f) });
+	add.Call({ make_ref(counter), make_copy(10), make_copy(0.5f) });
+	CHECK(counter.total == 20);
+	CHECK(add.Misses() == 2 && add.Hits() == 10);
+
+	CallSite twice("Twice");
+	twice.Call({ make_ref(counter), make_copy(1.5) });
+	twice.Call({ make_ref(counter), make_copy(3) });
+	CHECK(counter.total == 29);
+	CHECK(twice.Misses() == 2);
+
+	// no overload for the shape, nothing is cached.
+	CHECK(twice.Resolve({ make_ref(counter), make_copy(std::string("x")) }) == nullptr);
+	CHECK(twice.Misses() == 3);
+
+	// more shapes than ways evict the oldest one.
+	CallSite many("Add");
+	many.Call({ make_ref(counter), make_copy(1) });
+	for (int i = 0; i < int(CallSite::Ways); i++)
+	{
+		many.Resolve({ make_ref(counter), make_copy(1), make_copy(1.0f), make_copy(i) });
+	}
+	CHECK(many.Hits() == 0);
+
+	// registering again publishes a new version, the cached shape no longer matches.
+	uint64_t misses = add.Misses();
+	Registrar<Counter>().AddFunction(&Counter::Add, "Add");
+	add.Call({ make_ref(counter), make_copy(1) });
+	CHECK(add.Misses() == misses + 1);
+	add.Call({ make_ref(counter), make_copy(1) });
+	CHECK(add.Misses() == misses + 1);
+	CHECK(add.HitRate() > 0.5);
+	return 0;
+}
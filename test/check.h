@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+// assertion for the tests, stays on in release builds.
+#define CHECK(cond) \
+	do { if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); std::exit(1); } } while (0)
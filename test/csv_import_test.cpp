@@ -0,0 +1,86 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+enum class Side : uint8_t
+{
+	Buy = 1,
+	Sell = 2,
+};
+
+struct Trade
+{
+	int64_t id = 0;
+	double price = 0;
+	float quantity = 0;
+	uint16_t venue = 0;
+	Side side = Side::Buy;
+	bool open = false;
+	std::string symbol;
+};
+
+BEGIN_STATIC_CLASS(Trade)
+	static_var(id)
+	static_var(price)
+	static_var(quantity)
+	static_var(venue)
+	static_var(side)
+	static_var(open)
+	static_var(symbol)
+END_STATIC_CLASS(Trade)
+
+std::string generate(size_t rows)
+{
+	std::string text = "symbol,side,ignored,id,price,quantity,venue,open\n";
+	for (size_t i = 0; i < rows; i++)
+	{
+		text += "S" + std::to_string(i % 97) + (i % 3 ? ",Buy," : ",Sell,") + "x," + std::to_string(i) + "," +
+			std::to_string(i) + ".5," + std::to_string(i % 1000) + ".25," + std::to_string(i % 65536) + "," + (i % 2 ? "true" : "0") + "\n";
+	}
+	return text;
+}
+
+int main()
+{
+	Registrar<Side>().Regist("Side").Add("Buy", Side::Buy).Add("Sell", Side::Sell);
+
+	// columns are matched by name in any order, unknown ones are skipped.
+	std::vector<Trade> trades;
+	auto result = csv::Import("price,symbol,unknown,side,id\r\n1.5,AB,zz,Sell,7\r\n2.5,CD,zz,Buy,8", trades);
+	CHECK(result.rows == 2 && result.errors == 0);
+	CHECK(trades[0].price == 1.5 && trades[0].symbol == "AB" && trades[0].side == Side::Sell && trades[0].id == 7);
+	CHECK(trades[1].price == 2.5 && trades[1].symbol == "CD" && trades[1].side == Side::Buy && trades[1].id == 8);
+	CHECK(trades[1].quantity == 0 && trades[1].venue == 0);
+
+	// bad numbers, unknown enum items and bad bools are counted, rows are kept.
+	result = csv::Import("id;side;open;venue\n1x;Hold;maybe;70000\n2;Sell;false;3\n", trades, ';');
+	CHECK(result.rows == 2 && result.errors == 4);
+	CHECK(trades.size() == 4 && trades[3].id == 2 && trades[3].side == Side::Sell && trades[3].venue == 3);
+
+	// a header alone imports nothing.
+	result = csv::Import("id,price\n", trades);
+	CHECK(result.rows == 0 && trades.size() == 4);
+
+	// many chunks over several workers land every row in its own slot.
+	std::string text = generate(50000);
+	CHECK(text.size() > 64 * 4 * 1024);
+	std::vector<Trade> serial;
+	std::vector<Trade> parallel;
+	ThreadPool one(1);
+	ThreadPool four(4);
+	auto serialResult = csv::Import(text, serial, ',', one);
+	auto parallelResult = csv::Import(text, parallel, ',', four);
+	CHECK(serialResult.rows == 50000 && serialResult.errors == 0);
+	CHECK(parallelResult.rows == 50000 && parallelResult.errors == 0);
+	for (size_t i = 0; i < parallel.size(); i++)
+	{
+		auto& trade = parallel[i];
+		CHECK(trade.id == int64_t(i) && trade.price == double(i) + 0.5);
+		CHECK(trade.quantity == float(i % 1000) + 0.25f && trade.venue == i % 65536);
+		CHECK(trade.side == (i % 3 ? Side::Buy : Side::Sell) && trade.open == (i % 2 == 1));
+		CHECK(trade.symbol == serial[i].symbol && trade.symbol == "S" + std::to_string(i % 97));
+	}
+	return 0;
+}
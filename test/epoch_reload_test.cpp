@@ -0,0 +1,132 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+// 16 readers walk the members of a class while a writer keeps registering it
+// again with two or three members. Every reader must see the same Type, and
+// each version it loads must be complete and consistent. The writer starts
+// once every reader reads, and keeps reloading until each has seen a change.
+
+struct Reloaded
+{
+	int a;
+	float b;
+	double c;
+};
+
+BEGIN_STATIC_CLASS(Reloaded)
+	static_var(a)
+	static_var(b)
+	static_var(c)
+END_STATIC_CLASS(Reloaded)
+
+constexpr size_t Readers = 16;
+constexpr size_t MinReloads = 2000;
+
+void regist(bool wide)
+{
+	auto batch = Registrar<Reloaded>().Regist("Reloaded");
+	batch.AddVariable(&Reloaded::a, "a").AddVariable(&Reloaded::b, "b");
+	if (wide)
+	{
+		batch.AddVariable(&Reloaded::c, "c");
+	}
+}
+
+int main()
+{
+	regist(false);
+	const Type* identity = GetType<Reloaded>();
+	CHECK(identity->GetVersion() == 1);
+
+	std::atomic<bool> done{ false };
+	std::atomic<size_t> started{ 0 };
+	std::atomic<size_t> changed{ 0 };
+	std::atomic<size_t> reads{ 0 };
+	std::vector<std::thread> readers;
+	for (size_t t = 0; t < Readers; t++)
+	{
+		readers.emplace_back([&]
+		{
+			uint32_t first = 0;
+			uint32_t last = 0;
+			Reloaded obj{ 1, 2.0f, 3.0 };
+			started.fetch_add(1, std::memory_order_release);
+			while (!done.load(std::memory_order_acquire))
+			{
+				const Type* type = GetType<Reloaded>();
+				CHECK(type == identity);
+
+				epoch::Guard guard;
+				auto info = type->AsClass();
+				CHECK(info && info->GetName() == "Reloaded");
+
+				// one version, taken once, has to agree with itself.
+				auto& data = info->Current();
+				CHECK(data.version >= last);
+				if (first == 0)
+				{
+					first = data.version;
+				}
+				else if (last == first && data.version != first)
+				{
+					changed.fetch_add(1, std::memory_order_relaxed);
+				}
+				last = data.version;
+
+				size_t count = data.GetVariable().size();
+				CHECK(count == 2 || count == 3);
+				CHECK(data.GetMembers().size() == count);
+				CHECK(data.GetVisitSlots().size() == count);
+				CHECK(data.GetVariable()[count - 1].name == (count == 2 ? "b" : "c"));
+
+				size_t visited = 0;
+				VisitFields(obj, [&](std::string_view, auto&) { visited++; });
+				CHECK(visited == 2 || visited == 3);
+				reads.fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	while (started.load(std::memory_order_acquire) < Readers || reads.load(std::memory_order_relaxed) < Readers)
+	{
+		std::this_thread::yield();
+	}
+
+	// an even count ends on the two member version.
+	size_t reloads = 0;
+	while (reloads < MinReloads || reloads % 2 != 0 || changed.load(std::memory_order_relaxed) < Readers)
+	{
+		regist(reloads % 2 == 0);
+		reloads++;
+		if (reloads >= MinReloads)
+		{
+			std::this_thread::yield();
+		}
+	}
+	done.store(true, std::memory_order_release);
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	CHECK(GetType<Reloaded>() == identity);
+	CHECK(identity->GetVersion() == reloads + 1);
+	CHECK(identity->AsClass()->GetVariable().size() == 2);
+	CHECK(changed.load() == Readers);
+
+	// nothing reads any more, every retired version can go.
+	epoch::Domain::Instance().Reclaim();
+	CHECK(epoch::Domain::Instance().Pending() == 0);
+
+	// a later AddVariable extends the current version instead of starting over.
+	Registrar<Reloaded>().AddVariable(&Reloaded::c, "c");
+	CHECK(identity->AsClass()->GetVariable().size() == 3);
+	CHECK(identity->GetVersion() == reloads + 2);
+
+	Registrar<Reloaded>().UnRegist();
+	CHECK(identity->AsClass()->GetVariable().empty());
+	return 0;
+}
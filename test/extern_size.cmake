@@ -0,0 +1,21 @@
+# Compares the objects of the generated users built with and without
+# explicit instantiation, | separated lists in EXPLICIT and IMPLICIT.
+function(total_size list result)
+	string(REPLACE "|" ";" files "${list}")
+	set(total 0)
+	foreach(file ${files})
+		file(SIZE ${file} size)
+		math(EXPR total "${total} + ${size}")
+	endforeach()
+	set(${result} ${total} PARENT_SCOPE)
+endfunction()
+
+total_size("${EXPLICIT}" explicitBytes)
+total_size("${IMPLICIT}" implicitBytes)
+total_size("${EXPLICIT_EXE}" explicitExe)
+total_size("${IMPLICIT_EXE}" implicitExe)
+message(STATUS "user objects: ${explicitBytes} bytes with REFLECT_EXTERN_CLASS, ${implicitBytes} without")
+message(STATUS "executables:  ${explicitExe} bytes with REFLECT_EXTERN_CLASS, ${implicitExe} without")
+if(NOT explicitBytes LESS implicitBytes)
+	message(FATAL_ERROR "REFLECT_EXTERN_CLASS did not keep the factories out of the users")
+endif()
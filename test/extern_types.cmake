@@ -0,0 +1,56 @@
+# only touches files whose content changed, so reconfiguring does not rebuild them.
+function(write_if_changed path content)
+	if(EXISTS ${path})
+		file(READ ${path} old)
+		if(old STREQUAL content)
+			return()
+		endif()
+	endif()
+	file(WRITE ${path} "${content}")
+endfunction()
+
+# Writes the sources of the explicit instantiation test into ${dir}: ${count}
+# classes with a static table and REFLECT_EXTERN_CLASS in types.h, their
+# REFLECT_INSTANTIATE_CLASS in types.cpp, ${users} translation units that
+# register or use every class, and a main that checks the result.
+function(write_extern_types dir count users)
+	set(header "#pragma once\n#include \"reflect.h\"\n\n")
+	set(instantiate "#include \"types.h\"\n\n")
+	math(EXPR last "${count} - 1")
+	foreach(i RANGE ${last})
+		string(APPEND header "struct Type${i} { int a = ${i}; float b = 0; double c = 0; void Scale(float s) { b *= s; } };\n")
+		string(APPEND header "BEGIN_STATIC_CLASS(Type${i}) static_var(a) static_var(b) static_var(c) END_STATIC_CLASS(Type${i})\n")
+		string(APPEND header "REFLECT_EXTERN_CLASS(Type${i})\n")
+		string(APPEND instantiate "REFLECT_INSTANTIATE_CLASS(Type${i})\n")
+	endforeach()
+	write_if_changed(${dir}/types.h "${header}")
+	write_if_changed(${dir}/types.cpp "${instantiate}")
+
+	# user 0 registers, the others box values and read the registered names back.
+	set(main "#include \"types.h\"\n\n")
+	math(EXPR lastUser "${users} - 1")
+	foreach(u RANGE ${lastUser})
+		set(user "#include \"types.h\"\n\nsize_t user${u}()\n{\n\tsize_t sum = 0;\n")
+		foreach(i RANGE ${last})
+			if(u EQUAL 0)
+				string(APPEND user "\tRegistrar<Type${i}>().Regist(\"Type${i}\").AddVariable(&Type${i}::a, member_name_of(&Type${i}::a)).AddFunction(&Type${i}::Scale, member_name_of(&Type${i}::Scale));\n")
+			else()
+				string(APPEND user "\t{ Type${i} value; any boxed = make_copy(value); sum += boxed.typeInfo_ == GetType<Type${i}>() ? GetType<Type${i}>()->GetName().size() : 0; }\n")
+			endif()
+		endforeach()
+		string(APPEND user "\treturn sum;\n}\n")
+		write_if_changed(${dir}/user${u}.cpp "${user}")
+		string(APPEND main "size_t user${u}();\n")
+	endforeach()
+
+	string(APPEND main "\nint main()\n{\n\tepoch::Guard guard;\n\tif (user0() != 0)\n\t{\n\t\treturn 1;\n\t}\n\tsize_t sum = 0;\n")
+	foreach(u RANGE 1 ${lastUser})
+		string(APPEND main "\tsum += user${u}();\n")
+	endforeach()
+	string(APPEND main "\tsize_t expected = 0;\n")
+	foreach(i RANGE ${last})
+		string(APPEND main "\texpected += GetType<Type${i}>()->AsClass()->GetVariable().size() == 1 ? std::string_view(\"Type${i}\").size() : 1000;\n")
+	endforeach()
+	string(APPEND main "\treturn sum == expected * ${lastUser} ? 0 : 1;\n}\n")
+	write_if_changed(${dir}/main.cpp "${main}")
+endfunction()
@@ -0,0 +1,108 @@
+#include <string>
+#include <utility>
+#include "reflect.h"
+#include "check.h"
+
+// counts copies and moves of the payload so the invoker's binding is visible.
+struct Counted
+{
+	static inline int copies = 0;
+	static inline int moves = 0;
+	int value = 0;
+
+	Counted() = default;
+	Counted(const Counted& o) : value(o.value) { copies++; }
+	Counted(Counted&& o) noexcept : value(o.value) { moves++; }
+	Counted& operator=(const Counted& o) { value = o.value; copies++; return *this; }
+	Counted& operator=(Counted&& o) noexcept { value = o.value; moves++; return *this; }
+};
+
+struct Target
+{
+	int seen = 0;
+
+	int ByValue(Counted c) { return seen = c.value; }
+	int ByConstRef(const Counted& c) const { return c.value; }
+	int ByRef(Counted& c) { return ++c.value; }
+	int ByMove(Counted&& c) { Counted taken(std::move(c)); return seen = taken.value; }
+	int Consume(int x) && { return x * 2; }
+	int Safe(int x) const noexcept { return x + 1; }
+};
+
+int Free(int, double) noexcept { return 0; }
+int Variadic(const char*, ...) { return 0; }
+
+// every signature form resolves, with the qualifiers it was declared with.
+using FreeTraits = function_traits<decltype(&Free)>;
+static_assert(!FreeTraits::is_member && FreeTraits::is_noexcept && FreeTraits::arity == 2);
+static_assert(function_traits<decltype(Free)>::is_noexcept);
+static_assert(function_traits<decltype(&Variadic)>::is_variadic && function_traits<decltype(&Variadic)>::arity == 1);
+
+using Plain = function_traits<void(Target::*)(int)>;
+using Const = function_traits<void(Target::*)(int) const>;
+using Volatile = function_traits<void(Target::*)(int) volatile>;
+using ConstVolatile = function_traits<void(Target::*)(int) const volatile>;
+using LRef = function_traits<void(Target::*)(int) &>;
+using RRef = function_traits<void(Target::*)(int) const &&>;
+using NoExcept = function_traits<void(Target::*)(int) volatile & noexcept>;
+using MemberVariadic = function_traits<void(Target::*)(int, ...) const && noexcept>;
+
+static_assert(Plain::is_member && !Plain::is_const && !Plain::is_volatile && Plain::ref == ref_qualifier::None);
+static_assert(Const::is_const && !Const::is_volatile);
+static_assert(Volatile::is_volatile && !Volatile::is_const);
+static_assert(ConstVolatile::is_const && ConstVolatile::is_volatile);
+static_assert(LRef::ref == ref_qualifier::LValue && !LRef::is_noexcept);
+static_assert(RRef::ref == ref_qualifier::RValue && RRef::is_const);
+static_assert(NoExcept::is_noexcept && NoExcept::is_volatile && NoExcept::ref == ref_qualifier::LValue);
+static_assert(MemberVariadic::is_variadic && MemberVariadic::is_noexcept && MemberVariadic::is_const && MemberVariadic::ref == ref_qualifier::RValue);
+static_assert(std::is_same_v<MemberVariadic::class_type, Target> && MemberVariadic::arity == 1);
+
+static_assert(param_traits<Counted>::category == value_category::Value && param_traits<Counted>::can_move);
+static_assert(param_traits<const Counted&>::category == value_category::ConstLValueRef && !param_traits<const Counted&>::is_mutable);
+static_assert(param_traits<Counted&>::category == value_category::LValueRef && param_traits<Counted&>::is_mutable);
+static_assert(param_traits<Counted&&>::category == value_category::RValueRef && param_traits<Counted&&>::can_move);
+
+int call(const Class* info, const char* name, std::vector<any> args)
+{
+	auto& funcs = info->GetFunctions();
+	auto result = funcs[info->FindFunction(name)].call(args);
+	return *try_cast<int>(result);
+}
+
+int main()
+{
+	Registrar<Target>().Regist("Target")
+		.AddFunction(&Target::ByValue, "ByValue")
+		.AddFunction(&Target::ByConstRef, "ByConstRef")
+		.AddFunction(&Target::ByRef, "ByRef")
+		.AddFunction(&Target::ByMove, "ByMove")
+		.AddFunction(&Target::Consume, "Consume")
+		.AddFunction(&Target::Safe, "Safe");
+
+	const Class* info = GetType<Target>()->AsClass();
+	Target target;
+	Counted counted;
+	counted.value = 7;
+	any arg = make_ref(counted);
+	Counted::copies = Counted::moves = 0;
+
+	// references bind to the payload, nothing is copied or moved.
+	CHECK(call(info, "ByConstRef", { make_ref(target), make_cref(counted) }) == 7);
+	CHECK(call(info, "ByRef", { make_ref(target), arg }) == 8);
+	CHECK(counted.value == 8);
+	CHECK(Counted::copies == 0 && Counted::moves == 0);
+
+	// a by value parameter is constructed once from the payload.
+	CHECK(call(info, "ByValue", { make_ref(target), arg }) == 8);
+	CHECK(Counted::copies == 1 && Counted::moves == 0);
+
+	// T&& hands the payload over, the callee's move is the only one.
+	Counted::copies = 0;
+	CHECK(call(info, "ByMove", { make_ref(target), arg }) == 8);
+	CHECK(Counted::copies == 0 && Counted::moves == 1);
+
+	// && qualified and noexcept methods are callable through the same path.
+	CHECK(call(info, "Consume", { make_ref(target), make_copy(21) }) == 42);
+	CHECK(call(info, "Safe", { make_ref(target), make_copy(1) }) == 2);
+	return 0;
+}
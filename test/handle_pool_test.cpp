@@ -0,0 +1,110 @@
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Enemy
+{
+	std::string name;
+	int health = 0;
+};
+
+struct Bullet
+{
+	float speed = 0;
+};
+
+struct Spark
+{
+	static inline size_t constructed = 0;
+
+	Spark() { constructed++; }
+};
+
+int main()
+{
+	auto& enemies = HandlePool<Enemy>::Instance();
+
+	Handle a = enemies.Create(Enemy{ "a", 10 });
+	Handle b = enemies.Create(Enemy{ "b", 20 });
+	Handle c = enemies.Create(Enemy{ "c", 30 });
+	CHECK(a && b && c && a != b);
+	CHECK(enemies.Get(b)->health == 20);
+
+	// destroy swaps the last object into the hole, handles still resolve.
+	CHECK(enemies.Destroy(a));
+	CHECK(!enemies.Destroy(a));
+	CHECK(enemies.Get(a) == nullptr);
+	CHECK(enemies.Get(c)->name == "c" && enemies.Get(b)->name == "b");
+	CHECK(enemies.Size() == 2);
+
+	int total = 0;
+	for (auto& enemy : enemies)
+	{
+		total += enemy.health;
+	}
+	CHECK(total == 50);
+
+	// the reused slot gets a new generation, the old handle stays dead.
+	Handle d = enemies.Create(Enemy{ "d", 40 });
+	CHECK(d.index() == a.index() && d != a);
+	CHECK(enemies.Get(a) == nullptr && enemies.Get(d)->name == "d");
+
+	// a free slot matches no handle, whatever generation it is asked for.
+	CHECK(enemies.Destroy(d));
+	for (uint32_t generation = 0; generation <= Handle::GenerationMask; generation++)
+	{
+		CHECK(enemies.Get(Handle::Make(d.index(), generation)) == nullptr);
+	}
+	CHECK(enemies.Get(Handle::Make(Handle::IndexMask, 1)) == nullptr);
+	CHECK(enemies.Get(Handle{}) == nullptr);
+
+	// the type erased view finds the pool and walks it.
+	BasicHandlePool* pool = BasicHandlePool::Find(GetType<Enemy>());
+	CHECK(pool == &enemies && pool->Size() == 2 && pool->Stride() == sizeof(Enemy));
+	CHECK(pool->Resolve(pool->HandleAt(0)) == pool->Data());
+
+	// cycle one slot through every generation: no stale handle ever resolves
+	// again, and once the generation runs out the slot is retired.
+	auto& bullets = HandlePool<Bullet>::Instance();
+	Handle first = bullets.Create(Bullet{ 1 });
+	std::vector<Handle> stale{ first };
+	bullets.Destroy(first);
+	for (;;)
+	{
+		Handle next = bullets.Create(Bullet{ 2 });
+		if (next.index() != first.index())
+		{
+			CHECK(bullets.Retired() == 1);
+			CHECK(stale.size() == (Handle::GenerationMask + 1) / 2);
+			break;
+		}
+		for (Handle old : stale)
+		{
+			CHECK(bullets.Get(old) == nullptr);
+		}
+		stale.push_back(next);
+		bullets.Destroy(next);
+	}
+	for (Handle old : stale)
+	{
+		CHECK(bullets.Get(old) == nullptr);
+	}
+
+	// a full pool refuses, without constructing, until a slot is freed.
+	auto& sparks = HandlePool<Spark>::Instance();
+	Handle last;
+	for (uint32_t i = 0; i <= Handle::IndexMask; i++)
+	{
+		last = sparks.Create();
+	}
+	CHECK(last && last.index() == Handle::IndexMask);
+	CHECK(Spark::constructed == size_t(Handle::IndexMask) + 1);
+	CHECK(!sparks.Create());
+	CHECK(Spark::constructed == size_t(Handle::IndexMask) + 1 && sparks.Size() == Handle::IndexMask + 1);
+	CHECK(sparks.Get(last) != nullptr);
+	CHECK(sparks.Destroy(last));
+	Handle reused = sparks.Create();
+	CHECK(reused && reused.index() == last.index() && reused != last);
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include "reflect.h"
+#include "check.h"
+
+struct Person
+{
+	std::string familyName;
+	float height;
+	bool isFemale;
+};
+
+struct Padded
+{
+	char a;
+	double b;
+	char c;
+	int d;
+};
+
+struct Blob
+{
+	char bytes[40];
+};
+
+struct Wide
+{
+	double hot1;
+	Blob cold1;
+	double hot2;
+	double hot3;
+	Blob cold2;
+	int hot4;
+};
+
+BEGIN_STATIC_CLASS(Person)
+	static_var(familyName)
+	static_var(height)
+	static_var(isFemale)
+END_STATIC_CLASS(Person)
+
+BEGIN_STATIC_CLASS(Padded)
+	static_var(a)
+	static_var(b)
+	static_var(c)
+	static_var(d)
+END_STATIC_CLASS(Padded)
+
+BEGIN_STATIC_CLASS(Wide)
+	static_var(hot1)
+	static_var(cold1)
+	static_var(hot2)
+	static_var(hot3)
+	static_var(cold2)
+	static_var(hot4)
+END_STATIC_CLASS(Wide)
+
+int main()
+{
+	// Person ends in a bool, everything after it up to the alignment is tail padding.
+	auto person = layout::Analyze(GetStaticType<Person>());
+	size_t used = offsetof(Person, isFemale) + sizeof(bool);
+	CHECK(person.size == sizeof(Person));
+	CHECK(person.align == alignof(Person));
+	CHECK(person.fields.size() == 3);
+	CHECK(person.tailPadding == sizeof(Person) - used);
+	CHECK(person.tailPadding > 0);
+	CHECK(person.holes.back().offset == used);
+
+	std::ostringstream text;
+	text << person;
+	CHECK(text.str().find("(tail)") != std::string::npos);
+
+	// two inner holes, then the suggested order packs the doubles first.
+	auto padded = layout::Analyze(GetStaticType<Padded>());
+	CHECK(padded.holes.size() == 2);
+	CHECK(padded.holes[0].offset == 1 && padded.holes[0].size == offsetof(Padded, b) - 1);
+	CHECK(padded.holes[1].offset == offsetof(Padded, c) + 1);
+	CHECK(padded.padding == sizeof(Padded) - (2 * sizeof(char) + sizeof(double) + sizeof(int)));
+	CHECK(padded.suggestedOrder.size() == 4);
+	CHECK(padded.suggestedOrder[0] == "b" && padded.suggestedOrder[1] == "d");
+	CHECK(padded.suggestedOrder[2] == "a" && padded.suggestedOrder[3] == "c");
+	CHECK(padded.suggestedSize == 16);
+	CHECK(padded.suggestedSize < padded.size);
+
+	// accessed members go hot while they still fit one line, the rest stay cold.
+	uint64_t counts[] = { 900, 1, 800, 700, 0, 600 };
+	auto split = layout::SuggestHotCold(GetStaticType<Wide>(), counts);
+	CHECK(split.hot.size() == 4);
+	CHECK(split.hotSize <= 64);
+	CHECK(split.cold.size() == 2);
+	CHECK(split.cold[0] == "cold1" && split.cold[1] == "cold2");
+
+	// the first hot member that does not fit is moved to the cold side.
+	auto tight = layout::SuggestHotCold(GetStaticType<Wide>(), counts, 16);
+	CHECK(tight.hot.size() == 2);
+	CHECK(tight.hotSize == 16);
+	CHECK(tight.cold.size() == 4);
+	return 0;
+}
@@ -0,0 +1,53 @@
+#include <string>
+#include "reflect.h"
+#include "check.h"
+
+struct Widget
+{
+	int width = 0;
+	int height = 0;
+
+	void Resize(int w, int h) { width = w; height = h; }
+};
+
+static_assert(member_name("&Widget::Resize") == "Resize");
+static_assert(member_name("Widget::height") == "height");
+static_assert(member_name("&width") == "width");
+static_assert(member_name_of(&Widget::width).value == "width");
+
+int main()
+{
+	{
+		// run time names are copied by the batch, the sources die before it is frozen.
+		auto batch = Registrar<Widget>().Regist("Widget");
+		for (const char* prefix : { "w", "h" })
+		{
+			std::string name = std::string(prefix) + "_runtime_name_longer_than_sso";
+			batch.AddVariable(prefix[0] == 'w' ? &Widget::width : &Widget::height, name);
+			name.assign(name.size(), '?');
+		}
+		std::string method = "Resize";
+		batch.AddFunction(&Widget::Resize, method);
+		method = "??????";
+
+		// compile time names are kept as they are.
+		batch.AddVariable(&Widget::width, member_name_of(&Widget::width));
+	}
+
+	epoch::Guard guard;
+	const Class* info = GetType<Widget>()->AsClass();
+	CHECK(info->GetVariable().size() == 3);
+	CHECK(info->GetVariable()[0].name == "w_runtime_name_longer_than_sso");
+	CHECK(info->GetVariable()[1].name == "h_runtime_name_longer_than_sso");
+	CHECK(info->GetVariable()[2].name == "width");
+	CHECK(info->FindFunction("Resize") == 0);
+
+	// the factory level single adds take both kinds too.
+	std::string late = "late_runtime_name";
+	Registrar<Widget>().AddVariable(&Widget::height, late);
+	late.clear();
+	Registrar<Widget>().AddFunction(&Widget::Resize, member_name_of(&Widget::Resize));
+	CHECK(info->GetVariable()[3].name == "late_runtime_name");
+	CHECK(info->GetFunctions()[1].name == "Resize");
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <string>
+#include "reflect.h"
+#include "check.h"
+
+struct Part
+{
+	int32_t id = 0;
+	float weight = 0;
+	double price = 0;
+
+	void Move(float x, float y) { weight += x + y; }
+	void Turn(float x, float y) { weight -= x + y; }
+	int32_t Id() const { return id; }
+};
+
+BEGIN_STATIC_CLASS(Part)
+	static_var(id)
+	static_var(weight)
+	static_var(price)
+END_STATIC_CLASS(Part)
+
+struct Loose
+{
+	int32_t value = 0;
+};
+
+static_assert(has_static_type<Part>::value && !has_static_type<Loose>::value);
+static_assert(sizeof(VariableRecord) == 16);
+
+// true if [ptr, ptr + size) lies inside the table's block.
+template<typename Table>
+bool inside(const Table& table, const void* ptr, size_t size)
+{
+	auto begin = reinterpret_cast<const unsigned char*>(table.begin());
+	auto at = static_cast<const unsigned char*>(ptr);
+	return at >= begin && at + size <= begin + table.Bytes();
+}
+
+int main()
+{
+	{
+		// names built at run time, gone before the class is used.
+		std::string names[] = { "id", "weight", "price", "Move", "Turn", "Id" };
+		Registrar<Part>().Regist("Part")
+			.AddVariable(&Part::id, names[0], attr::replicated)
+			.AddVariable(&Part::weight, names[1], attr::range(0, 10))
+			.AddVariable(&Part::price, names[2])
+			.AddFunction(&Part::Move, names[3], attr::editor_only)
+			.AddFunction(&Part::Turn, names[4])
+			.AddFunction(&Part::Id, names[5]);
+		for (auto& name : names)
+		{
+			name.assign(name.size(), '?');
+		}
+	}
+
+	epoch::Guard guard;
+	const Class* info = GetType<Part>()->AsClass();
+	auto& data = info->Current();
+	auto& members = data.GetMembers();
+	auto& functions = data.GetDispatch();
+
+	// the hot records start the 64 byte aligned block, everything else follows in it.
+	CHECK(reinterpret_cast<uintptr_t>(members.begin()) % 64 == 0);
+	CHECK(members.size() == 3 && functions.size() == 3);
+	CHECK(members[0].offset == offsetof(Part, id) && members[2].offset == offsetof(Part, price));
+	CHECK(members[0].attrs == attr::Replicated && members[0].type == GetType<int32_t>());
+	for (size_t i = 0; i < members.size(); i++)
+	{
+		auto& var = data.GetVariable()[i];
+		CHECK(inside(members, &var, sizeof(var)));
+		CHECK(inside(members, var.name.data(), var.name.size()));
+		CHECK(var.name == members.GetCold(i).name);
+	}
+	for (size_t i = 0; i < functions.size(); i++)
+	{
+		auto& func = data.GetFunctions()[i];
+		CHECK(inside(functions, &func, sizeof(func)));
+		CHECK(inside(functions, func.name.data(), func.name.size()));
+	}
+	CHECK(data.GetVariable()[1].name == "weight" && data.GetFunctions()[2].name == "Id");
+	CHECK(info->GetVariableRange(1)->max == 10 && info->GetVariableRange(0) == nullptr);
+	CHECK(info->GetFunctionAttr(0) == attr::EditorOnly && info->FindFunction("Turn") == 1);
+
+	// one static parameter list per signature, shared by Move and Turn.
+	auto& move = data.GetFunctions()[0];
+	auto& turn = data.GetFunctions()[1];
+	CHECK(move.paramType.size() == 2 && move.paramType[0] == GetType<float>());
+	CHECK(move.paramType.begin() == turn.paramType.begin());
+	CHECK(data.GetFunctions()[2].paramType.empty());
+
+	// the members work through the packed copies.
+	Part part;
+	float weight = 2.5f;
+	info->SetVariable(&part, 1, &weight);
+	CHECK(part.weight == 2.5f);
+	float args[2] = { 1.0f, 2.0f };
+	const void* columns[2] = { &args[0], &args[1] };
+	functions[0].invoker(&part, columns, 0);
+	CHECK(part.weight == 5.5f);
+
+	// a later batch keeps what the table held, attributes and ranges included.
+	Registrar<Part>().AddVariable(&Part::price, "cost", attr::range(1, 2));
+	auto& next = info->Current();
+	CHECK(next.GetVariable().size() == 4 && next.GetFunctions().size() == 3);
+	CHECK(next.GetVariableAttr(0) == attr::Replicated && next.GetVariableRange(1)->max == 10);
+	CHECK(next.GetVariableRange(3)->min == 1 && next.GetFunctionAttr(0) == attr::EditorOnly);
+	CHECK(next.GetVariable()[1].name == "weight" && next.GetMembers()[3].offset == VariableRecord::InvalidOffset);
+
+	// without a static table no offsets are known.
+	Registrar<Loose>().Regist("Loose").AddVariable(&Loose::value, "value");
+	CHECK(GetType<Loose>()->AsClass()->GetMembers()[0].offset == VariableRecord::InvalidOffset);
+	return 0;
+}
@@ -0,0 +1,100 @@
+#define REFLECT_MEMORY_STATS
+#include <string>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Blob
+{
+	char bytes[256];
+	std::string name;
+};
+
+memstats::Usage payloads(const Type* type)
+{
+	for (auto& usage : memstats::Capture().types)
+	{
+		if (usage.type == type)
+		{
+			return usage.payloads;
+		}
+	}
+	return {};
+}
+
+int64_t mode(any::storage_type type)
+{
+	return memstats::Capture().modes[size_t(type)].count;
+}
+
+int main()
+{
+	Registrar<Blob>().Regist("Blob").AddVariable(&Blob::name, "name");
+	const Type* type = GetType<Blob>();
+	Blob blob{};
+
+	{
+		any copy = make_copy(blob);
+		CHECK(payloads(type).count == 1);
+		CHECK(payloads(type).bytes == int64_t(sizeof(Blob)));
+
+		// a copy of a copy is a second Copy payload, released as one.
+		any twice = copy;
+		CHECK(twice.store_type == any::storage_type::Copy);
+		CHECK(mode(any::storage_type::Copy) == 2);
+
+		// a copied reference shares the object and allocates nothing.
+		any ref = make_ref(blob);
+		any alias = ref;
+		CHECK(alias.store_type == any::storage_type::Ref && alias.payload_ == &blob);
+		any calias = make_cref(blob);
+		any calias2 = calias;
+		CHECK(calias2.payload_ == &blob);
+		CHECK(payloads(type).count == 2);
+
+		// a copy of a stolen payload is a Copy, the stolen one stays a Steal.
+		any stolen = make_steal(Blob{});
+		any fromStolen = stolen;
+		CHECK(fromStolen.store_type == any::storage_type::Copy);
+		CHECK(mode(any::storage_type::Steal) == 1);
+		CHECK(mode(any::storage_type::Copy) == 3);
+	}
+	CHECK(payloads(type).count == 0 && payloads(type).bytes == 0);
+	for (auto& usage : memstats::Capture().modes)
+	{
+		CHECK(usage.count == 0);
+	}
+
+	// shards are summed, churn on several threads nets out.
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 8; t++)
+	{
+		threads.emplace_back([&]
+		{
+			for (int i = 0; i < 1000; i++)
+			{
+				any value = make_copy(blob);
+				any again = value;
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	CHECK(payloads(type).count == 0);
+
+	// metadata is the footprint of the current version.
+	bool found = false;
+	for (auto& usage : memstats::Capture().types)
+	{
+		if (usage.type == type)
+		{
+			found = true;
+			CHECK(usage.metadata == int64_t(type->AsClass()->MemoryUsage()));
+		}
+	}
+	CHECK(found);
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <cstring>
+#include "reflect.h"
+#include "check.h"
+
+struct Wide
+{
+	double values[9];
+};
+
+struct Account
+{
+	int64_t balance = 0;
+	uint32_t deposits = 0;
+
+	void Deposit(int64_t amount, uint8_t times) { balance += amount * times; deposits += times; }
+	void Scale(float factor) { balance = int64_t(double(balance) * factor); }
+	void Absorb(Wide wide) { balance += int64_t(wide.values[8]); }
+	void Many(int a, int b, int c, int d, int e, int f, int g, int h, int i) { balance += a + b + c + d + e + f + g + h + i; }
+};
+
+// the packed layout is by decreasing alignment, ties in declaration order.
+static_assert(packed_offsets<char, double, int>()[0] == 12);
+static_assert(packed_offsets<char, double, int>()[1] == 0);
+static_assert(packed_offsets<char, double, int>()[2] == 8);
+static_assert(packed_size<char, double, int> == 16);
+static_assert(packed_size<char, char> == 2 && packed_align<char, char> == 1);
+static_assert(packed_size<> == 0);
+
+int main()
+{
+	Registrar<Account>().Regist("Account")
+		.AddFunction(&Account::Deposit, "Deposit")
+		.AddFunction(&Account::Scale, "Scale")
+		.AddFunction(&Account::Absorb, "Absorb")
+		.AddFunction(&Account::Many, "Many");
+
+	const Class* info = GetType<Account>()->AsClass();
+	uint32_t deposit = info->FindFunction("Deposit");
+	uint32_t scale = info->FindFunction("Scale");
+	uint32_t absorb = info->FindFunction("Absorb");
+	uint32_t many = info->FindFunction("Many");
+
+	Account account;
+
+	// typed: the compiler checks the arguments against the method.
+	Message message;
+	message.info = info;
+	message.obj = &account;
+	message.methodId = deposit;
+	PackArgs(message, &Account::Deposit, int64_t(5), uint8_t(3));
+	CHECK(info->Dispatch(&account, message.methodId, message.args));
+	CHECK(account.balance == 15 && account.deposits == 3);
+
+	// untyped: checked against the registered parameter types.
+	CHECK(PackArgs(message, int64_t(10), uint8_t(1)));
+	CHECK(Dispatch(&account, message.methodId, message.args));
+	CHECK(account.balance == 25 && account.deposits == 4);
+
+	// wrong types, wrong arity, unknown ids and classes leave the buffer alone.
+	std::memset(message.args, 0xab, sizeof(message.args));
+	CHECK(!PackArgs(message, 10, uint8_t(1)));
+	CHECK(!PackArgs(message, int64_t(10)));
+	CHECK(!PackArgs(message, int64_t(10), uint8_t(1), 1.0f));
+	message.methodId = 99;
+	CHECK(!PackArgs(message, int64_t(10), uint8_t(1)));
+	message.methodId = Class::InvalidMethod;
+	CHECK(!PackArgs(message, int64_t(10), uint8_t(1)));
+	Message empty;
+	CHECK(!PackArgs(empty, 1.0f));
+	CHECK(message.args[0] == 0xab && message.args[Message::ArgCapacity - 1] == 0xab);
+
+	message.methodId = scale;
+	CHECK(PackArgs(message, 2.0f));
+	CHECK(Dispatch(&account, scale, message.args));
+	CHECK(account.balance == 50);
+
+	// out of range ids and methods whose arguments cannot be packed are refused.
+	CHECK(!info->Dispatch(&account, 4, message.args));
+	CHECK(!info->Dispatch(&account, Class::InvalidMethod, message.args));
+	CHECK(!info->Dispatch(&account, absorb, message.args));
+	CHECK(!info->Dispatch(&account, many, message.args));
+	CHECK(account.balance == 50);
+
+	// a 72 byte argument does not fit, PackArgs(message, Wide{}) does not compile.
+	message.methodId = absorb;
+	CHECK(sizeof(Wide) > Message::ArgCapacity);
+	CHECK(!PackArgs(message, 1));
+
+	// the pump counts what it dispatched and what it refused.
+	{
+		MessagePump pump(1);
+		Message post;
+		post.info = info;
+		post.obj = &account;
+		post.methodId = deposit;
+		CHECK(PackArgs(post, int64_t(1), uint8_t(1)));
+		for (int i = 0; i < 100; i++)
+		{
+			while (!pump.Post(post)) {}
+		}
+		post.methodId = 1000;
+		while (!pump.Post(post)) {}
+		while (pump.Processed() + pump.Rejected() < 101) {}
+		CHECK(pump.Processed() == 100 && pump.Rejected() == 1);
+	}
+	CHECK(account.balance == 150 && account.deposits == 104);
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+enum class Rank : uint8_t
+{
+	Low = 1,
+	High = 2,
+};
+
+// the record as an older build wrote it.
+struct StoredItem
+{
+	int32_t id;
+	float weight;
+	int16_t level;
+	uint8_t count;
+	Rank rank;
+	double dropped;
+};
+
+// the live class: widened, reordered, one member removed and two added.
+struct Item
+{
+	double weight = 0;
+	int64_t id = 0;
+	int32_t level = 0;
+	uint16_t added = 7;
+	uint8_t count = 0;
+	Rank rank = Rank::Low;
+	float extra = 0.5f;
+};
+
+// an unsigned enum widened to a wider integer must not sign extend.
+struct StoredBadge
+{
+	Rank rank;
+};
+
+struct Badge
+{
+	uint32_t rank = 0;
+};
+
+BEGIN_STATIC_ENUM(Rank)
+	static_item(Low)
+	static_item(High)
+END_STATIC_ENUM(Rank)
+
+BEGIN_STATIC_CLASS(StoredItem)
+	static_var(id)
+	static_var(weight)
+	static_var(level)
+	static_var(count)
+	static_var(rank)
+	static_var(dropped)
+END_STATIC_CLASS(StoredItem)
+
+BEGIN_STATIC_CLASS(Item)
+	static_var(weight)
+	static_var(id)
+	static_var(level)
+	static_var(added)
+	static_var(count)
+	static_var(rank)
+	static_var(extra)
+END_STATIC_CLASS(Item)
+
+BEGIN_STATIC_CLASS(StoredBadge)
+	static_var(rank)
+END_STATIC_CLASS(StoredBadge)
+
+BEGIN_STATIC_CLASS(Badge)
+	static_var(rank)
+END_STATIC_CLASS(Badge)
+
+int main()
+{
+	auto file = snapshot::Writer().AddClass(GetStaticType<StoredItem>()).Build();
+	snapshot::View view(file.data(), file.size());
+	CHECK(view.IsValid());
+	auto stored = view.FindClass("StoredItem");
+	CHECK(stored != nullptr);
+
+	auto plan = migrate::Plan::Build<Item>(view, *stored);
+	using Kind = migrate::Step::Kind;
+	size_t copies = 0, converts = 0, defaults = 0;
+	for (auto& step : plan.GetSteps())
+	{
+		copies += step.kind == Kind::Copy;
+		converts += step.kind == Kind::Convert;
+		defaults += step.kind == Kind::Default;
+	}
+	// weight, id, level convert; count and rank copy as one run; added and extra default.
+	CHECK(converts == 3 && copies == 1 && defaults == 2);
+
+	std::vector<StoredItem> records(1000);
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		records[i] = StoredItem{ int32_t(i) - 500, float(i) * 0.25f, int16_t(-int(i)), uint8_t(i), i % 2 ? Rank::High : Rank::Low, 99.0 };
+	}
+
+	std::vector<Item> items(records.size());
+	plan.Run(records.data(), records.size(), items.data());
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		CHECK(items[i].id == int64_t(i) - 500);
+		CHECK(items[i].weight == double(float(i) * 0.25f));
+		CHECK(items[i].level == -int(i));
+		CHECK(items[i].count == uint8_t(i) && items[i].rank == (i % 2 ? Rank::High : Rank::Low));
+		CHECK(items[i].added == 7 && items[i].extra == 0.5f);
+	}
+
+	// identical layouts collapse to a single copy of the whole record.
+	auto same = snapshot::Writer().AddClass(GetStaticType<Item>()).Build();
+	snapshot::View sameView(same.data(), same.size());
+	auto identity = migrate::Plan::Build<Item>(sameView, *sameView.FindClass("Item"));
+	CHECK(identity.GetSteps().size() == 1 && identity.GetSteps()[0].kind == Kind::Copy);
+
+	auto badges = snapshot::Writer().AddClass(GetStaticType<StoredBadge>()).Build();
+	snapshot::View badgeView(badges.data(), badges.size());
+	auto widen = migrate::Plan::Build<Badge>(badgeView, *badgeView.FindClass("StoredBadge"));
+	CHECK(widen.GetSteps().size() == 1 && widen.GetSteps()[0].kind == Kind::Convert);
+	StoredBadge storedBadges[2] = { { Rank(0x80) }, { Rank(0xFF) } };
+	Badge liveBadges[2];
+	widen.Run(storedBadges, 2, liveBadges);
+	CHECK(liveBadges[0].rank == 0x80 && liveBadges[1].rank == 0xFF);
+
+	// a stored member past the end of its record is never read.
+	auto corrupt = file;
+	snapshot::View corruptView(corrupt.data(), corrupt.size());
+	auto member = corruptView.FindVariable(*corruptView.FindClass("StoredItem"), "id");
+	uint32_t farOffset = 1 << 20;
+	std::memcpy(corrupt.data() + (reinterpret_cast<const char*>(&member->offset) - corrupt.data()), &farOffset, sizeof(farOffset));
+	auto guarded = migrate::Plan::Build<Item>(corruptView, *corruptView.FindClass("StoredItem"));
+	CHECK(guarded.GetSteps().size() == plan.GetSteps().size());
+	CHECK(guarded.GetSteps()[1].kind == Kind::Default);
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Door
+{
+	int32_t angle = 0;
+	int32_t locked = 0;
+};
+
+struct Lamp
+{
+	float power = 0;
+};
+
+struct Log
+{
+	std::vector<std::pair<void*, uint32_t>> calls;
+};
+
+static void record(void* user, void* object, const Type*, uint32_t member)
+{
+	static_cast<Log*>(user)->calls.emplace_back(object, member);
+}
+
+int main()
+{
+	Registrar<Door>().Regist("Door").AddVariable(&Door::angle, "angle").AddVariable(&Door::locked, "locked");
+	Registrar<Lamp>().Regist("Lamp").AddVariable(&Lamp::power, "power");
+	const Class* door = GetType<Door>()->AsClass();
+	const Class* lamp = GetType<Lamp>()->AsClass();
+	CHECK(door->GetId() != lamp->GetId());
+
+	auto& hub = observe::Hub::Instance();
+	Door a, b;
+	Lamp l, m;
+	int32_t value = 10;
+
+	// nothing listens, nothing is recorded.
+	door->SetVariable(&a, 0, &value);
+	CHECK(hub.Pending() == 0);
+
+	Log angle, all;
+	uint32_t angleId = hub.Subscribe(door, 0, record, &angle);
+	uint32_t allId = hub.Subscribe(door, observe::AllMembers, record, &all);
+	CHECK(angleId != 0 && allId != 0 && angleId != allId);
+
+	// repeated writes to one member of one object coalesce.
+	for (int i = 0; i < 100; i++)
+	{
+		door->SetVariable(&a, 0, &value);
+	}
+	door->SetVariable(&a, 1, &value);
+	door->SetVariable(&b, 0, &value);
+	CHECK(a.angle == 10 && a.locked == 10);
+	CHECK(hub.Pending() == 3);
+
+	// a class nobody listens to stays a single load.
+	float power = 1;
+	lamp->SetVariable(&l, 0, &power);
+	CHECK(hub.Pending() == 3);
+
+	hub.Flush();
+	CHECK(hub.Pending() == 0);
+	CHECK(angle.calls.size() == 2);
+	CHECK(all.calls.size() == 3);
+
+	// writes from several threads to the same member are delivered once.
+	all.calls.clear();
+	{
+		std::vector<std::thread> writers;
+		for (int t = 0; t < 4; t++)
+		{
+			writers.emplace_back([&]
+			{
+				int32_t v = 1;
+				for (int i = 0; i < 1000; i++)
+				{
+					door->SetVariable(&b, 1, &v);
+				}
+			});
+		}
+		for (auto& writer : writers)
+		{
+			writer.join();
+		}
+	}
+	// the writers have exited, what they recorded is still there.
+	CHECK(hub.Pending() >= 1);
+	hub.Flush();
+	CHECK(all.calls.size() == 1 && all.calls[0].first == &b && all.calls[0].second == 1);
+
+	// subscribing from inside a subscriber, and re-registering the class, keep working.
+	static Log late;
+	uint32_t subscribeId = hub.Subscribe(lamp, 0, [](void*, void*, const Type* type, uint32_t)
+	{
+		observe::Hub::Instance().Subscribe(type, 0, record, &late);
+	});
+	lamp->SetVariable(&l, 0, &power);
+	hub.Flush();
+	CHECK(late.calls.empty());
+	CHECK(hub.Unsubscribe(subscribeId));
+	Registrar<Lamp>().Regist("Lamp").AddVariable(&Lamp::power, "power");
+	lamp->SetVariable(&m, 0, &power);
+	hub.Flush();
+	CHECK(late.calls.size() == 1 && late.calls[0].first == &m);
+
+	// unsubscribed lists are not called again.
+	CHECK(hub.Unsubscribe(angleId));
+	CHECK(hub.Unsubscribe(allId));
+	CHECK(!hub.Unsubscribe(allId));
+	angle.calls.clear();
+	all.calls.clear();
+	door->SetVariable(&a, 0, &value);
+	CHECK(hub.Pending() == 0);
+	hub.Flush();
+	CHECK(angle.calls.empty() && all.calls.empty());
+	return 0;
+}
@@ -0,0 +1,46 @@
+#include <string>
+#include <tuple>
+#include "packed_layout.h"
+#include "check.h"
+
+struct Tracked
+{
+	static inline int live = 0;
+	int value;
+
+	Tracked(int v = 0) : value(v) { live++; }
+	Tracked(const Tracked& o) : value(o.value) { live++; }
+	Tracked& operator=(const Tracked&) = default;
+	~Tracked() { live--; }
+};
+
+using Args = packed_tuple<char, double, int, char, short>;
+static_assert(sizeof(Args) == 16 && alignof(Args) == alignof(double));
+static_assert(Args::offset<1> == 0 && Args::offset<2> == 8 && Args::offset<4> == 12);
+static_assert(Args::offset<0> == 14 && Args::offset<3> == 15);
+
+int main()
+{
+	Args args{ 'a', 1.5, 7, 'b', 3 };
+	CHECK(get<0>(args) == 'a' && get<1>(args) == 1.5 && get<2>(args) == 7);
+	CHECK(get<3>(args) == 'b' && get<4>(args) == 3);
+
+	get<2>(args) = 9;
+	const Args copy = args;
+	CHECK(get<2>(copy) == 9 && get<0>(copy) == 'a');
+
+	// elements with constructors and destructors are run exactly once.
+	{
+		using Mixed = packed_tuple<bool, std::string, Tracked>;
+		Mixed mixed{ true, std::string(64, 'x'), Tracked(5) };
+		CHECK(Tracked::live == 1);
+		Mixed other;
+		CHECK(Tracked::live == 2);
+		other = mixed;
+		CHECK(get<1>(other).size() == 64 && get<2>(other).value == 5 && get<0>(other));
+		Mixed third = other;
+		CHECK(Tracked::live == 3);
+	}
+	CHECK(Tracked::live == 0);
+	return 0;
+}
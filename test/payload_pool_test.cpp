@@ -0,0 +1,101 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+using payload::Pool;
+
+struct Record
+{
+	char bytes[200];
+};
+
+int main()
+{
+	// blocks are aligned to their size class and reused once freed.
+	for (size_t size = 1; size <= Pool::MaxClass; size *= 2)
+	{
+		void* a = Pool::Allocate(size, 1);
+		CHECK(reinterpret_cast<uintptr_t>(a) % std::max(size, Pool::MinClass) == 0);
+		Pool::Deallocate(a, size, 1);
+		CHECK(Pool::Allocate(size, 1) == a);
+		Pool::Deallocate(a, size, 1);
+	}
+
+	// slabs whose blocks all came back are released, one per class is kept.
+	size_t before = Pool::SlabCount();
+	{
+		std::vector<void*> blocks;
+		for (int i = 0; i < 100000; i++)
+		{
+			blocks.push_back(Pool::Allocate(64, 8));
+		}
+		CHECK(Pool::SlabCount() >= before + 100000 * 64 / Pool::SlabSize);
+		for (void* block : blocks)
+		{
+			Pool::Deallocate(block, 64, 8);
+		}
+	}
+	CHECK(Pool::SlabCount() <= before + 1);
+
+	// a producer allocates, a consumer frees: blocks go back to the producer's
+	// slabs, so memory stays flat however many pass through.
+	constexpr size_t Count = 2000000;
+	size_t peak = 0;
+	{
+		mpmc_queue<any> queue(1024);
+		std::atomic<bool> done{ false };
+		std::thread consumer([&]
+		{
+			any value;
+			for (;;)
+			{
+				if (queue.try_pop(value))
+				{
+					value = any();
+				}
+				else if (done.load(std::memory_order_acquire))
+				{
+					break;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		Record record{};
+		for (size_t i = 0; i < Count; i++)
+		{
+			while (!queue.try_push(make_copy(record)))
+			{
+				std::this_thread::yield();
+			}
+			peak = std::max(peak, Pool::SlabCount());
+		}
+		done.store(true, std::memory_order_release);
+		consumer.join();
+	}
+	// 1024 queued payloads of 256 bytes are 4 slabs, leave room for the ones in flight.
+	CHECK(peak <= before + 16);
+
+	// blocks of an exited thread freed here go back to its heap, which the
+	// next thread takes over instead of carving new slabs.
+	std::vector<void*> blocks(50000);
+	std::thread([&] { for (auto& block : blocks) block = Pool::Allocate(128, 8); }).join();
+	size_t orphaned = Pool::SlabCount();
+	for (void* block : blocks)
+	{
+		Pool::Deallocate(block, 128, 8);
+	}
+	std::thread([&] { for (auto& block : blocks) block = Pool::Allocate(128, 8); }).join();
+	CHECK(Pool::SlabCount() == orphaned);
+	for (void* block : blocks)
+	{
+		Pool::Deallocate(block, 128, 8);
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+enum class Level : uint8_t
+{
+	Low = 1,
+	High = 200,
+};
+
+struct Record
+{
+	std::string name;
+	float height;
+	bool isFemale;
+	int64_t id;
+	uint32_t count;
+	Level level;
+};
+
+BEGIN_STATIC_CLASS(Record)
+	static_var(name)
+	static_var(height)
+	static_var(isFemale)
+	static_var(id)
+	static_var(count)
+	static_var(level)
+END_STATIC_CLASS(Record)
+
+int main()
+{
+	Registrar<Level>().Regist("Level").Add("Low", Level::Low).Add("High", Level::High);
+
+	// ids next to each other above 2^53 are the same double.
+	constexpr int64_t big = (int64_t(1) << 53) + 1;
+	std::vector<Record> rows;
+	for (int i = 0; i < 3000; i++)
+	{
+		rows.push_back(Record{ "r", 1.5f + float(i % 10) * 0.1f, i % 3 == 0, big + i % 4 - 1, uint32_t(i), i % 2 ? Level::High : Level::Low });
+	}
+
+	using namespace query;
+	auto& info = GetStaticType<Record>();
+
+	auto tall = Compile(Field(info, "height") > 1.8 && Field(info, "isFemale"));
+	CHECK(tall.Valid() && tall.Error().empty());
+	auto picked = tall.Filter(rows.data(), rows.size());
+	size_t expected = 0;
+	for (auto& row : rows)
+	{
+		expected += row.height > 1.8 && row.isFemale;
+	}
+	CHECK(picked.size() == expected);
+	for (uint32_t idx : picked)
+	{
+		CHECK(rows[idx].height > 1.8 && rows[idx].isFemale);
+	}
+
+	// int64 against an integer constant is exact, through double both ids would match.
+	auto exact = Compile(Field(info, "id") == big);
+	CHECK(exact.Filter(rows.data(), rows.size()).size() == 750);
+	CHECK(Compile(Field(info, "id") > big).Filter(rows.data(), rows.size()).size() == 1500);
+	CHECK(Compile(Field(info, "id") >= big - 1).Filter(rows.data(), rows.size()).size() == 3000);
+
+	// unsigned members against negative constants, and enums by their underlying value.
+	CHECK(Compile(Field(info, "count") > -1).Filter(rows.data(), rows.size()).size() == 3000);
+	CHECK(Compile(Field(info, "count") < -1).Filter(rows.data(), rows.size()).empty());
+	CHECK(Compile(Field(info, "level") > 100).Filter(rows.data(), rows.size()).size() == 1500);
+	CHECK(Compile(!(Field(info, "count") < 1000) || Field(info, "count") == 5u).Filter(rows.data(), rows.size()).size() == 2001);
+
+	// an unknown or non numeric member is an error, not a null dereference.
+	auto unknown = Compile(Field(info, "heigth") > 1.8 && Field(info, "isFemale"));
+	CHECK(!unknown.Valid());
+	CHECK(unknown.Error() == "unknown member 'heigth'");
+	CHECK(unknown.Filter(rows.data(), rows.size()).empty());
+
+	auto text = Compile(Field(info, "isFemale") || Field(info, "name") == 1);
+	CHECK(!text.Valid());
+	CHECK(text.Error() == "member 'name' is not a numeric or enum field");
+	return 0;
+}
@@ -0,0 +1,80 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Big
+{
+	static inline std::atomic<int> live{ 0 };
+	static inline std::atomic<int> copies{ 0 };
+
+	int values[1024] = {};
+
+	Big() { live++; }
+	Big(const Big& o) { std::copy(std::begin(o.values), std::end(o.values), values); live++; copies++; }
+	Big(Big&& o) noexcept { std::copy(std::begin(o.values), std::end(o.values), values); live++; }
+	~Big() { live--; }
+};
+
+int main()
+{
+	{
+		Big big;
+		big.values[0] = 1;
+		any shared = make_share(std::move(big));
+		Big::copies = 0;
+
+		// copies share the payload, the value is never copied.
+		std::vector<any> args(8, shared);
+		any another = shared;
+		CHECK(Big::copies == 0 && another.payload_ == shared.payload_ && args[7].payload_ == shared.payload_);
+		CHECK(another.store_type == any::storage_type::Shared);
+
+		// reads never duplicate it either.
+		const any& view = another;
+		CHECK(try_cast<Big>(view)->values[0] == 1 && Big::copies == 0);
+
+		// the first write through one owner takes a private copy.
+		try_cast<Big>(another)->values[0] = 2;
+		CHECK(Big::copies == 1 && another.payload_ != shared.payload_);
+		CHECK(try_cast<Big>(view)->values[0] == 2);
+		CHECK(static_cast<const Big*>(shared.payload_)->values[0] == 1);
+
+		// the sole owner writes in place.
+		try_cast<Big>(another)->values[1] = 3;
+		CHECK(Big::copies == 1);
+
+		// stealing from a shared payload shares it, the others still read it.
+		any stolen = std::move(args[0]);
+		CHECK(stolen.payload_ == shared.payload_ && args[0].store_type == any::storage_type::Empty);
+		any taken(static_cast<const any&>(args[1]));
+		CHECK(taken.payload_ == shared.payload_ && Big::copies == 1);
+	}
+	// every owner is gone, so is every payload.
+	CHECK(Big::live == 0);
+
+	// owners on several threads copy and drop concurrently, the last frees it.
+	{
+		any shared = make_share(Big{});
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; t++)
+		{
+			threads.emplace_back([source = any(shared)]
+			{
+				for (int i = 0; i < 20000; i++)
+				{
+					any copy = source;
+					std::vector<any> list{ copy, copy };
+				}
+			});
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		CHECK(Big::live == 1 && shared_box<Big>::From(shared.payload_)->refs == 1);
+	}
+	CHECK(Big::live == 0 && Big::copies == 1);
+	return 0;
+}
@@ -0,0 +1,153 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+struct Vec2
+{
+	float x;
+	float y;
+};
+
+struct Player
+{
+	int32_t health;
+	double speed;
+	Vec2 position;
+};
+
+enum class Team : uint8_t
+{
+	Red = 1,
+	Blue = 2,
+};
+
+BEGIN_STATIC_CLASS(Vec2)
+	static_var(x)
+	static_var(y)
+END_STATIC_CLASS(Vec2)
+
+BEGIN_STATIC_CLASS(Player)
+	static_var(health)
+	static_var(speed)
+	static_var(position)
+END_STATIC_CLASS(Player)
+
+BEGIN_STATIC_ENUM(Team)
+	static_item(Red)
+	static_item(Blue)
+END_STATIC_ENUM(Team)
+
+// the bytes of file with one field overwritten.
+template<typename T>
+std::vector<char> patched(std::vector<char> file, size_t offset, T value)
+{
+	std::memcpy(file.data() + offset, &value, sizeof(T));
+	return file;
+}
+
+snapshot::View view_of(const std::vector<char>& file)
+{
+	return snapshot::View(file.data(), file.size());
+}
+
+int main()
+{
+	auto file = snapshot::Writer()
+		.AddClass(GetStaticType<Player>())
+		.AddClass(GetStaticType<Vec2>())
+		.AddEnum(GetStaticType<Team>())
+		.Build();
+
+	auto view = view_of(file);
+	CHECK(view.IsValid() && view.Error().empty());
+	CHECK(view.GetClasses().size() == 2 && view.GetEnums().size() == 1);
+
+	auto player = view.FindClass("Player");
+	CHECK(player && player->size == sizeof(Player) && view.FindClass("Enemy") == nullptr);
+	auto speed = view.FindVariable(*player, "speed");
+	CHECK(speed && speed->offset == offsetof(Player, speed) && view.GetString(speed->typeName) == "double");
+	CHECK((speed->numeric & 0xFF) == uint32_t(Numeric::Kind::Double));
+	auto health = view.FindVariable(*player, "health");
+	CHECK(health && (health->numeric & snapshot::NumericSigned));
+	auto team = view.FindEnum("Team");
+	CHECK(team && view.GetItems(*team).size() == 2 && view.GetItems(*team)[1].value == 2);
+
+	// the header and every record slice are checked before anything is read.
+	using snapshot::Header;
+	using snapshot::ClassRecord;
+	auto& header = view.GetHeader();
+
+	CHECK(!snapshot::View(file.data(), sizeof(Header) - 1).IsValid());
+	CHECK(!snapshot::View(file.data(), file.size() - 1).IsValid());
+	CHECK(!view_of(patched(file, offsetof(Header, magic), 'X')).IsValid());
+	CHECK(view_of(patched(file, offsetof(Header, version), uint32_t(1))).Error().find("version 1") != std::string_view::npos);
+	CHECK(view_of(patched(file, offsetof(Header, version), uint32_t(2))).Error().find("version 2") != std::string_view::npos);
+	CHECK(!view_of(patched(file, offsetof(Header, version), uint32_t(4))).IsValid());
+	CHECK(!view_of(patched(file, offsetof(Header, classCount), uint32_t(1u << 30))).IsValid());
+	CHECK(!view_of(patched(file, offsetof(Header, classOffset), header.classOffset + 1)).IsValid());
+	CHECK(!view_of(patched(file, offsetof(Header, stringOffset), header.fileSize + 1)).IsValid());
+	CHECK(!view_of(patched(file, offsetof(Header, memberOffset), header.fileSize - 8)).IsValid());
+	CHECK(!view_of(patched(file, offsetof(Header, enumCount), uint32_t(~0u))).IsValid());
+
+	size_t first = header.classOffset;
+	CHECK(!view_of(patched(file, first + offsetof(ClassRecord, memberCount), uint32_t(~0u))).IsValid());
+	CHECK(!view_of(patched(file, first + offsetof(ClassRecord, firstMember), uint32_t(~0u))).IsValid());
+	CHECK(!view_of(patched(file, first + offsetof(ClassRecord, name), snapshot::StrRef{ 0, header.fileSize })).IsValid());
+	CHECK(!view_of(patched(file, header.memberOffset, snapshot::StrRef{ ~0u, 4 })).IsValid());
+	CHECK(!view_of(patched(file, header.itemOffset, snapshot::StrRef{ 1, ~0u })).IsValid());
+
+	// classes out of name order would break the binary search.
+	auto swapped = file;
+	std::memcpy(swapped.data() + first, file.data() + first + sizeof(ClassRecord), sizeof(ClassRecord));
+	std::memcpy(swapped.data() + first + sizeof(ClassRecord), file.data() + first, sizeof(ClassRecord));
+	CHECK(view_of(swapped).Error().find("unsorted") != std::string_view::npos);
+
+	// any single corrupted byte either fails the check or leaves a file whose
+	// every record and string can be walked.
+	size_t accepted = 0;
+	for (size_t i = 0; i < file.size(); i++)
+	{
+		for (int bit = 0; bit < 8; bit++)
+		{
+			auto corrupt = file;
+			corrupt[i] ^= char(1 << bit);
+			auto check = view_of(corrupt);
+			if (!check.IsValid())
+			{
+				continue;
+			}
+			accepted++;
+			size_t length = 0;
+			for (auto& info : check.GetClasses())
+			{
+				length += check.GetString(info.name).size();
+				for (auto& member : check.GetVariable(info))
+				{
+					length += check.GetString(member.name).size() + check.GetString(member.typeName).size();
+				}
+			}
+			for (auto& info : check.GetEnums())
+			{
+				for (auto& item : check.GetItems(info))
+				{
+					length += check.GetString(item.name).size();
+				}
+			}
+			CHECK(length <= check.GetHeader().fileSize);
+		}
+	}
+	CHECK(accepted > 0);
+
+	// mapped from disk, with the reason when it cannot be.
+	std::string path = "snapshot_test.bin";
+	CHECK(snapshot::Writer().AddClass(GetStaticType<Player>()).Save(path));
+	snapshot::MappedFile mapped;
+	CHECK(mapped.Open(path) && mapped.GetView().FindClass("Player") != nullptr);
+	mapped.Close();
+	std::remove(path.c_str());
+	CHECK(!mapped.Open("snapshot_test_missing.bin") && mapped.Error() == "cannot open the file");
+	return 0;
+}
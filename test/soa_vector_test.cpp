@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "soa_vector.h"
+#include "check.h"
+
+struct Particle
+{
+	float x;
+	double mass;
+	bool alive;
+	std::string tag;
+};
+
+// soa_vector only needs the member pointers of TypeInfo<T>::variables.
+template<typename Ptr>
+struct column_of
+{
+	Ptr pointer;
+};
+
+template<typename Ptr>
+column_of(Ptr) -> column_of<Ptr>;
+
+template<>
+struct TypeInfo<Particle>
+{
+	static constexpr auto variables = std::make_tuple(column_of{ &Particle::x }, column_of{ &Particle::mass }, column_of{ &Particle::alive }, column_of{ &Particle::tag });
+};
+
+int main()
+{
+	soa_vector<Particle> particles;
+	CHECK(particles.empty());
+
+	for (int i = 0; i < 1000; i++)
+	{
+		particles.push_back(Particle{ float(i), i * 2.0, i % 2 == 0, std::to_string(i) });
+	}
+	CHECK(particles.size() == 1000);
+
+	// every column is contiguous and indexed like the elements.
+	auto xs = particles.column<&Particle::x>();
+	auto alive = particles.column<2>();
+	CHECK(xs.size() == 1000 && alive.size() == 1000);
+	float sum = 0;
+	for (float x : xs)
+	{
+		sum += x;
+	}
+	CHECK(sum == 999.0f * 1000.0f / 2.0f);
+	CHECK(alive[10] && !alive[11]);
+
+	// proxies read and write across all columns.
+	Particle p = particles[42];
+	CHECK(p.x == 42.0f && p.mass == 84.0 && p.alive && p.tag == "42");
+	particles[42] = Particle{ -1.0f, -2.0, false, "moved" };
+	CHECK(particles.column<&Particle::tag>()[42] == "moved");
+	particles[43].get<&Particle::mass>() = 7.0;
+	CHECK(Particle(particles[43]).mass == 7.0);
+
+	// bulk append touches each column once.
+	std::vector<Particle> more(500, Particle{ 1.0f, 1.0, true, "more" });
+	particles.append(more.data(), more.size());
+	CHECK(particles.size() == 1500);
+	CHECK(particles.column<&Particle::tag>()[1499] == "more");
+
+	particles.erase(0, 1000);
+	CHECK(particles.size() == 500);
+	CHECK(Particle(particles[0]).tag == "more");
+
+	particles.push_back(Particle{ 9.0f, 9.0, false, "last" });
+	particles.swap_remove(0);
+	CHECK(particles.size() == 500);
+	CHECK(Particle(particles[0]).tag == "last");
+
+	const soa_vector<Particle> copy = particles;
+	CHECK(copy.size() == 500 && copy.column<&Particle::x>()[0] == 9.0f);
+
+	// one at a time appends grow geometrically, not by the appended count.
+	soa_column<int> column;
+	size_t reallocations = 0;
+	for (int i = 0; i < 100000; i++)
+	{
+		size_t capacity = column.capacity();
+		column.append(&i, 1);
+		reallocations += column.capacity() != capacity;
+	}
+	CHECK(column.size() == 100000);
+	CHECK(reallocations <= 14);
+	CHECK(column[99999] == 99999);
+
+	// growing hands out value initialized slots, in every column.
+	soa_column<float> floats;
+	floats.resize(1000);
+	CHECK(std::all_of(floats.data(), floats.data() + 1000, [](float v) { return v == 0.0f; }));
+	column.resize(10);
+	column.resize(50000);
+	CHECK(column[9] == 9 && column[10] == 0 && column[49999] == 0);
+
+	soa_vector<Particle> grown;
+	grown.resize(300);
+	CHECK(grown.column<&Particle::x>()[299] == 0.0f && grown.column<&Particle::mass>()[0] == 0.0 && !grown.column<&Particle::alive>()[150]);
+	return 0;
+}
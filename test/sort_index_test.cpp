@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+enum class Signed : int8_t
+{
+	Low = -100,
+	Zero = 0,
+	High = 100,
+};
+
+enum class Unsigned : uint8_t
+{
+	Low = 1,
+	High = 200,
+};
+
+struct Row
+{
+	int32_t i;
+	uint8_t u;
+	float f;
+	double d;
+	Signed s;
+	Unsigned e;
+	std::string name;
+};
+
+BEGIN_STATIC_CLASS(Row)
+	static_var(i)
+	static_var(u)
+	static_var(f)
+	static_var(d)
+	static_var(s)
+	static_var(e)
+	static_var(name)
+END_STATIC_CLASS(Row)
+
+// the permutation must match a stable sort with a plain comparator.
+template<typename Index, typename Less>
+bool ordered(const std::vector<Row>& rows, const std::vector<Index>& index, Less less)
+{
+	std::vector<Index> expected(rows.size());
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		expected[i] = Index(i);
+	}
+	std::stable_sort(expected.begin(), expected.end(), [&](Index a, Index b) { return less(rows[a], rows[b]); });
+	return index == expected;
+}
+
+int main()
+{
+	Registrar<Signed>().Regist("Signed").Add("Low", Signed::Low).Add("Zero", Signed::Zero).Add("High", Signed::High);
+	Registrar<Unsigned>().Regist("Unsigned").Add("Low", Unsigned::Low).Add("High", Unsigned::High);
+
+	std::mt19937 rng(7);
+	std::vector<Row> rows(5000);
+	const Signed signs[] = { Signed::Low, Signed::Zero, Signed::High };
+	for (auto& row : rows)
+	{
+		row.i = int32_t(rng()) % 1000;
+		row.u = uint8_t(rng());
+		row.f = float(int(rng() % 2001) - 1000) / 7.0f;
+		row.d = rng() % 5 == 0 ? -0.0 : double(int64_t(rng()) - (int64_t(1) << 31)) * 1e-3;
+		row.s = signs[rng() % 3];
+		row.e = rng() % 2 ? Unsigned::Low : Unsigned::High;
+		row.name = std::to_string(rng());
+	}
+
+	ThreadPool pool(2);
+	auto& info = GetStaticType<Row>();
+	auto& vars = info.GetVariable();
+
+	CHECK(ordered(rows, BuildIndex(rows.data(), rows.size(), vars[0], pool), [](auto& a, auto& b) { return a.i < b.i; }));
+	CHECK(ordered(rows, BuildIndex(rows.data(), rows.size(), vars[1], pool), [](auto& a, auto& b) { return a.u < b.u; }));
+	CHECK(ordered(rows, BuildIndex(rows.data(), rows.size(), vars[2], pool), [](auto& a, auto& b) { return a.f < b.f; }));
+	CHECK(ordered(rows, BuildIndex(rows.data(), rows.size(), vars[4], pool), [](auto& a, auto& b) { return a.s < b.s; }));
+	CHECK(ordered(rows, BuildIndex(rows.data(), rows.size(), vars[5], pool), [](auto& a, auto& b) { return a.e < b.e; }));
+
+	// -0.0 sorts before +0.0 by its bits, compare the keys that differ by value only.
+	auto byDouble = BuildIndex(rows.data(), rows.size(), vars[3], pool);
+	CHECK(std::is_sorted(byDouble.begin(), byDouble.end(), [&](uint32_t a, uint32_t b) { return rows[a].d < rows[b].d; }));
+
+	// the enum keys follow the underlying type: int8 -100 before 0, uint8 200 after 1.
+	CHECK(GetType<Signed>()->AsEnum()->isSigned());
+	CHECK(!GetType<Unsigned>()->AsEnum()->isSigned());
+	CHECK(rows[BuildIndex(rows.data(), rows.size(), vars[4], pool).front()].s == Signed::Low);
+	CHECK(rows[BuildIndex(rows.data(), rows.size(), vars[5], pool).back()].e == Unsigned::High);
+
+	// a member without a key gives no index, and SortBy leaves the items alone.
+	CHECK(BuildIndex(rows.data(), rows.size(), vars[6], pool).empty());
+	std::vector<Row> copy = rows;
+	CHECK(!SortBy(copy.data(), copy.size(), vars[6], pool));
+	CHECK(copy[0].name == rows[0].name && copy[4999].name == rows[4999].name);
+
+	// an index type too small for the count gives no index instead of wrapping.
+	CHECK(BuildIndex<uint8_t>(rows.data(), 256, vars[0], pool).size() == 256);
+	CHECK(BuildIndex<uint8_t>(rows.data(), 257, vars[0], pool).empty());
+	CHECK(BuildIndex<uint64_t>(rows.data(), rows.size(), vars[0], pool).size() == rows.size());
+
+	CHECK(SortBy(copy.data(), copy.size(), vars[0], pool));
+	CHECK(std::is_sorted(copy.begin(), copy.end(), [](auto& a, auto& b) { return a.i < b.i; }));
+	CHECK(SortBy(copy.data(), 0, vars[0], pool));
+	return 0;
+}
@@ -0,0 +1,60 @@
+#include <cstddef>
+#include "reflect.h"
+#include "check.h"
+
+struct Point
+{
+	float x;
+	double y;
+	char tag;
+};
+
+enum class Color : uint8_t
+{
+	Red = 1,
+	Green = 4,
+};
+
+BEGIN_STATIC_CLASS(Point)
+	static_var(x)
+	static_var(y)
+	static_var(tag)
+END_STATIC_CLASS(Point)
+
+BEGIN_STATIC_ENUM(Color)
+	static_item(Red)
+	static_item(Green)
+END_STATIC_ENUM(Color)
+
+// everything below is answered by the compiler, nothing runs before main.
+static_assert(GetStaticType<Point>().name == "Point");
+static_assert(GetStaticType<Point>().size == sizeof(Point));
+static_assert(GetStaticType<Point>().GetVariable().size() == 3);
+static_assert(GetStaticType<Point>().GetVariable().Find("y")->offset == offsetof(Point, y));
+static_assert(GetStaticType<Point>().GetVariable().Find("tag")->size == 1);
+static_assert(GetStaticType<Point>().GetVariable().Find("z") == nullptr);
+static_assert(GetStaticType<Color>().GetItems()[1].name == "Green");
+static_assert(GetStaticType<Color>().GetItems()[1].value == 4);
+
+int main()
+{
+	auto& info = GetStaticType<Point>();
+
+	// the Type getter is the only thing resolved on demand.
+	CHECK(info.GetVariable()[0].type() == GetType<float>());
+	CHECK(info.GetVariable()[1].type() == GetType<double>());
+	CHECK(info.GetVariable()[1].type()->GetName() == "double");
+	CHECK(info.GetVariable()[2].type()->GetKind() == Type::Kind::Numeric);
+
+	Point point{ 1.5f, 2.5, 'p' };
+	auto& y = info.GetVariable()[1];
+	CHECK(*reinterpret_cast<double*>(reinterpret_cast<char*>(&point) + y.offset) == 2.5);
+
+	size_t items = 0;
+	for (auto& item : GetStaticType<Color>().GetItems())
+	{
+		items += item.value;
+	}
+	CHECK(items == 5);
+	return 0;
+}
@@ -0,0 +1,127 @@
+#include <string>
+#include <vector>
+#include "reflect.h"
+#include "check.h"
+
+enum class Mood : uint16_t
+{
+	Calm = 1,
+	Angry = 7,
+};
+
+// x has an offset in the static table, y is registered at run time only.
+struct Placed
+{
+	int x = 0;
+	double y = 0;
+};
+
+BEGIN_STATIC_CLASS(Placed)
+	static_var(x)
+END_STATIC_CLASS(Placed)
+
+// no static table at all, every member is found through its address thunk.
+// vector is an unregistered class, it arrives as a ClassRef with no members.
+struct Loose
+{
+	int count = 0;
+	float speed = 0;
+	std::string label;
+	Mood mood = Mood::Calm;
+	Placed inner;
+	std::vector<int> opaque;
+};
+
+int main()
+{
+	Registrar<Mood>().Regist("Mood").Add("Calm", Mood::Calm).Add("Angry", Mood::Angry);
+	Registrar<Placed>().Regist("Placed").AddVariable(&Placed::x, "x").AddVariable(&Placed::y, "y");
+	Registrar<Loose>().Regist("Loose")
+		.AddVariable(&Loose::count, "count")
+		.AddVariable(&Loose::speed, "speed")
+		.AddVariable(&Loose::label, "label")
+		.AddVariable(&Loose::mood, "mood")
+		.AddVariable(&Loose::inner, "inner")
+		.AddVariable(&Loose::opaque, "opaque");
+
+	// ids are stable and resolve back to their Type.
+	const Type* placedType = GetType<Placed>();
+	const Type* looseType = GetType<Loose>();
+	CHECK(placedType->GetId() != looseType->GetId());
+	CHECK(Type::FromId(placedType->GetId()) == placedType);
+	CHECK(Type::FromId(looseType->GetId()) == looseType);
+	CHECK(Type::FromId(~0u) == nullptr);
+
+	// the static offset and the runtime only member are both visited, in order.
+	Placed placed;
+	std::vector<std::string> names;
+	VisitFields(placed, [&](std::string_view name, auto& value)
+	{
+		names.emplace_back(name);
+		if constexpr (std::is_arithmetic_v<std::remove_reference_t<decltype(value)>>)
+		{
+			value = 3;
+		}
+	});
+	CHECK(names.size() == 2 && names[0] == "x" && names[1] == "y");
+	CHECK(placed.x == 3 && placed.y == 3.0);
+
+	// writes through the visitor land in the object.
+	Loose loose;
+	loose.inner.y = 1.5;
+	names.clear();
+	const Class* nested = nullptr;
+	void* nestedData = nullptr;
+	VisitFields(loose, [&](std::string_view name, auto& value)
+	{
+		using U = std::remove_reference_t<decltype(value)>;
+		names.emplace_back(name);
+		if constexpr (std::is_same_v<U, int>)
+		{
+			value = 42;
+		}
+		else if constexpr (std::is_same_v<U, float>)
+		{
+			value = 2.5f;
+		}
+		else if constexpr (std::is_same_v<U, std::string>)
+		{
+			value = "visited";
+		}
+		else if constexpr (std::is_same_v<U, visit::EnumRef>)
+		{
+			CHECK(value.info == GetType<Mood>()->AsEnum());
+			CHECK(value.size == sizeof(Mood) && value.Get() == uint64_t(Mood::Calm));
+			value.Set(uint64_t(Mood::Angry));
+		}
+		else if constexpr (std::is_same_v<U, visit::ClassRef>)
+		{
+			if (name == "inner")
+			{
+				nested = value.Info();
+				nestedData = value.data;
+			}
+			else
+			{
+				CHECK(value.data == &loose.opaque && value.Info()->GetVariable().empty());
+			}
+		}
+	});
+	CHECK(names.size() == 6 && names[5] == "opaque");
+	CHECK(loose.count == 42 && loose.speed == 2.5f && loose.label == "visited");
+	CHECK(loose.mood == Mood::Angry);
+
+	// the nested view visits like any object of its class.
+	CHECK(nested == placedType->AsClass() && nestedData == &loose.inner);
+	double seen = 0;
+	VisitFields(*nested, nestedData, [&](std::string_view name, auto& value)
+	{
+		if constexpr (std::is_same_v<std::remove_reference_t<decltype(value)>, double>)
+		{
+			CHECK(name == "y");
+			seen = value;
+		}
+	});
+	CHECK(seen == 1.5);
+	return 0;
+}